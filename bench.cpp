@@ -0,0 +1,1028 @@
+/// @file bench.cpp
+/// @brief Benchmarks for the CanvasList and Shape classes. Each benchmark
+///     prints one line per problem size so scaling can be compared at a
+///     glance. Pass benchmark names on the command line to run a subset,
+///     e.g. ./bench.exe push_back copy
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <iostream>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+#include "canvaslist.h"
+#include "canvasvector.h"
+#include "bulktransform.h"
+#include "canvasfile.h"
+#include "canvasparser.h"
+#include "canvassearch.h"
+#include "canvasstats.h"
+#include "canvasview.h"
+#include "columncanvas.h"
+#include "concurrentcanvas.h"
+#include "cowcanvas.h"
+#include "persistentcanvas.h"
+#include "shapebvh.h"
+#include "shardedcanvas.h"
+#include "simdlevel.h"
+#include "framebuffer.h"
+#include "ingeststack.h"
+#include "rasterizer.h"
+#include "threadpool.h"
+#include "tilerenderer.h"
+#include "shape.h"
+#include "valuecanvas.h"
+
+using namespace std;
+
+// returns seconds elapsed since start
+static double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// prints a single result line in a fixed layout
+static void report(const char *name, int n, double seconds) {
+    cout << name << "  n=" << n << "  total=" << seconds * 1e3 << " ms"
+         << "  per-op=" << seconds * 1e9 / n << " ns" << endl;
+}
+
+// stream buffer that throws away everything written to it
+// lets draw() be timed without measuring the terminal
+class NullBuffer : public streambuf
+{
+    protected:
+        int overflow(int c) override { return c; }
+        streamsize xsputn(const char *, streamsize n) override { return n; }
+};
+
+// builds a canvas of n mixed shapes using push_back
+template <class Canvas>
+static void fill(Canvas &canvas, int n) {
+    for (int i = 0; i < n; i++) {
+        switch (i % 4) {
+            case 0: canvas.push_back(new Shape(i, i)); break;
+            case 1: canvas.push_back(new Circle(i, i, 3)); break;
+            case 2: canvas.push_back(new Rect(i, i, 4, 5)); break;
+            default: canvas.push_back(new RightTriangle(i, i, 6, 7)); break;
+        }
+    }
+}
+
+// push_back should cost the same per shape at every size
+static void benchPushBack() {
+    for (int n = 1000; n <= 1000000; n *= 10) {
+        CanvasList canvas;
+        auto start = chrono::steady_clock::now();
+        fill(canvas, n);
+        report("push_back", n, secondsSince(start));
+    }
+}
+
+// pop_back should cost the same per shape at every size
+static void benchPopBack() {
+    for (int n = 1000; n <= 1000000; n *= 10) {
+        CanvasList canvas;
+        fill(canvas, n);
+        auto start = chrono::steady_clock::now();
+        while (!canvas.isempty()) {
+            delete canvas.pop_back();
+        }
+        report("pop_back", n, secondsSince(start));
+    }
+}
+
+// copy constructor and assignment operator should be linear
+static void benchCopy() {
+    for (int n = 1000; n <= 1000000; n *= 10) {
+        CanvasList original;
+        fill(original, n);
+
+        auto start = chrono::steady_clock::now();
+        CanvasList copy(original);
+        report("copy-ctor", n, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        copy = original;
+        report("operator=", n, secondsSince(start));
+    }
+}
+
+// steady-state churn should not need new slabs once the list is built
+static void benchPool() {
+    for (int n = 1000; n <= 1000000; n *= 10) {
+        CanvasList canvas;
+        fill(canvas, n);
+        PoolStats before = canvas.poolStats();
+
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < n; i++) {
+            canvas.push_back(canvas.pop_front());
+        }
+        double seconds = secondsSince(start);
+        PoolStats after = canvas.poolStats();
+        report("pool-churn", n, seconds);
+        cout << "    slab mallocs during churn: "
+             << after.slabAllocations - before.slabAllocations
+             << "  nodes handed out: " << after.nodeAllocations - before.nodeAllocations << endl;
+
+        start = chrono::steady_clock::now();
+        canvas.clear();
+        report("pool-clear", n, secondsSince(start));
+    }
+}
+
+// times push, indexed access, find and draw for one storage layout
+template <class Canvas>
+static void benchLayoutOne(const char *label, int n, int samples) {
+    string name = label;
+    Canvas canvas;
+
+    auto start = chrono::steady_clock::now();
+    fill(canvas, n);
+    report((name + "-push").c_str(), n, secondsSince(start));
+
+    // scatters the sampled indices across the whole canvas
+    long checksum = 0;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < samples; i++) {
+        checksum += canvas.shapeAt(static_cast<int>(i * 2654435761UL % n))->getX();
+    }
+    report((name + "-shapeAt").c_str(), samples, secondsSince(start));
+
+    // looks for a point that is not on the canvas so every shape is visited
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < 3; i++) {
+        checksum += canvas.find(-1, -1);
+    }
+    report((name + "-find").c_str(), 3 * n, secondsSince(start));
+
+    NullBuffer nullBuffer;
+    streambuf *saved = cout.rdbuf(&nullBuffer);
+    start = chrono::steady_clock::now();
+    canvas.draw();
+    double seconds = secondsSince(start);
+    cout.rdbuf(saved);
+    report((name + "-draw").c_str(), n, seconds);
+
+    if (checksum == 42) {
+        cout << "    (checksum " << checksum << ")" << endl;
+    }
+}
+
+// compares the linked list against the contiguous array layout
+static void benchLayout() {
+    for (int n : {1000, 100000, 10000000}) {
+        // the list walks up to n/2 nodes per lookup so it gets fewer samples
+        int listSamples = max(10, min(n, 100000000 / n));
+        benchLayoutOne<CanvasList>("list", n, listSamples);
+        benchLayoutOne<CanvasVector>("vector", n, n);
+    }
+}
+
+// hit-tests existing points with and without the hash index
+static void benchFindIndex() {
+    for (int n = 1000; n <= 1000000; n *= 10) {
+        CanvasList canvas;
+        fill(canvas, n);
+        int queries = max(100, min(100000, 1000000000 / n / 10));
+        cout << "canvas of " << n << " shapes" << endl;
+
+        for (int indexed = 0; indexed < 2; indexed++) {
+            if (indexed) {
+                canvas.enableFindIndex();
+            }
+            long checksum = 0;
+            auto start = chrono::steady_clock::now();
+            for (int i = 0; i < queries; i++) {
+                int target = static_cast<int>(i * 2654435761UL % n);
+                checksum += canvas.find(target, target);
+            }
+            report(indexed ? "find-hashed" : "find-linear", queries, secondsSince(start));
+            if (checksum < 0) {
+                cout << "    (missing point)" << endl;
+            }
+        }
+    }
+}
+
+// builds a canvas of n mixed shapes scattered over a square world
+// most shapes are small and every hundredth one is a large background
+static void scatter(CanvasList &canvas, int n, int world) {
+    for (int i = 0; i < n; i++) {
+        int x = static_cast<int>(i * 2654435761UL % world);
+        int y = static_cast<int>(i * 40503UL % world);
+        int size = (i % 100 == 0) ? world / 4 : 2 + i % 13;
+        switch (i % 4) {
+            case 0: canvas.push_back(new Shape(x, y)); break;
+            case 1: canvas.push_back(new Circle(x, y, size)); break;
+            case 2: canvas.push_back(new Rect(x, y, size, size)); break;
+            default: canvas.push_back(new RightTriangle(x, y, size, size)); break;
+        }
+    }
+}
+
+// which shapes cover a pixel, with and without the spatial grid
+static void benchGrid() {
+    const int world = 20000;
+    for (int n = 1000; n <= 1000000; n *= 10) {
+        CanvasList canvas;
+        scatter(canvas, n, world);
+        int queries = max(100, min(100000, 1000000000 / n / 10));
+        cout << "canvas of " << n << " shapes" << endl;
+
+        for (int gridded = 0; gridded < 2; gridded++) {
+            if (gridded) {
+                auto start = chrono::steady_clock::now();
+                canvas.enableSpatialIndex(64);
+                report("grid-build", n, secondsSince(start));
+            }
+            size_t hits = 0;
+            auto start = chrono::steady_clock::now();
+            for (int i = 0; i < queries; i++) {
+                hits += canvas.shapesAt(static_cast<int>(i * 7919UL % world), static_cast<int>(i * 104729UL % world)).size();
+            }
+            report(gridded ? "shapesAt-grid" : "shapesAt-linear", queries, secondsSince(start));
+            cout << "    hits: " << hits << endl;
+        }
+    }
+}
+
+// bulk loaded hierarchy against the linear find scan on a static canvas
+static void benchBVH() {
+    const int world = 20000;
+    for (int n = 10000; n <= 1000000; n *= 10) {
+        CanvasList canvas;
+        scatter(canvas, n, world);
+        int queries = max(100, min(10000, 1000000000 / n / 10));
+        cout << "canvas of " << n << " shapes" << endl;
+
+        long checksum = 0;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < queries; i++) {
+            int target = static_cast<int>(i * 2654435761UL % n);
+            checksum += canvas.find(target, target);
+        }
+        report("find-linear", queries, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        ShapeBVH bvh(canvas);
+        report("bvh-build", n, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < queries; i++) {
+            checksum += bvh.queryPoint(static_cast<int>(i * 7919UL % world), static_cast<int>(i * 104729UL % world)).size();
+        }
+        report("bvh-point", queries, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < queries; i++) {
+            int x = static_cast<int>(i * 7919UL % world);
+            int y = static_cast<int>(i * 104729UL % world);
+            checksum += bvh.queryWindow(Bounds{x, y, x + 200, y + 200}).size();
+        }
+        report("bvh-window", queries, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < queries; i++) {
+            checksum += bvh.nearest(static_cast<int>(i * 7919UL % world), static_cast<int>(i * 104729UL % world), 8).size();
+        }
+        report("bvh-nearest8", queries, secondsSince(start));
+        cout << "    checksum: " << checksum << endl;
+    }
+}
+
+// fills canvases of growing size into a 4K framebuffer
+static void benchRaster() {
+    Framebuffer fb(3840, 2160);
+    for (int n = 10000; n <= 1000000; n *= 10) {
+        CanvasList canvas;
+        scatter(canvas, n, 3840);
+
+        fb.clear(0);
+        auto start = chrono::steady_clock::now();
+        long pixels = Rasterizer::render(canvas, fb);
+        double seconds = secondsSince(start);
+        report("raster", n, seconds);
+        cout << "    " << n / seconds / 1e6 << " M shapes/s  "
+             << pixels / seconds / 1e6 << " megapixels/s  (" << pixels << " pixels)" << endl;
+    }
+}
+
+// renders an 8K frame on 1 to N worker threads
+static void benchTiles() {
+    Framebuffer fb(7680, 4320);
+    CanvasList canvas;
+    scatter(canvas, 1000000, 7680);
+
+    auto start = chrono::steady_clock::now();
+    long pixels = Rasterizer::render(canvas, fb);
+    double serial = secondsSince(start);
+    report("tiles-serial", canvas.size(), serial);
+
+    int cores = max(1, static_cast<int>(thread::hardware_concurrency()));
+    for (int threads = 1; threads <= cores; threads *= 2) {
+        ThreadPool pool(threads);
+        TileRenderer renderer(pool);
+        renderer.render(canvas, fb);
+
+        start = chrono::steady_clock::now();
+        renderer.render(canvas, fb);
+        double seconds = secondsSince(start);
+        cout << "tiles  threads=" << threads << "  total=" << seconds * 1e3 << " ms"
+             << "  speedup=" << serial / seconds << "x  "
+             << pixels / seconds / 1e6 << " megapixels/s  steals=" << pool.stealCount() << endl;
+        if (threads < cores && threads * 2 > cores) {
+            threads = cores / 2;
+        }
+    }
+}
+
+// one flushed line per shape against the block buffered draw paths
+static void benchDraw() {
+    NullBuffer nullBuffer;
+    ostream nullStream(&nullBuffer);
+    int devNull = open("/dev/null", O_WRONLY);
+
+    for (int n = 1000; n <= 1000000; n *= 10) {
+        CanvasList canvas;
+        fill(canvas, n);
+
+        auto start = chrono::steady_clock::now();
+        for (ShapeNode *curr = canvas.front(); curr != nullptr; curr = curr->next) {
+            nullStream << curr->value->printShape() << endl;
+        }
+        report("draw-endl", n, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        canvas.draw(nullStream);
+        report("draw-ostream", n, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        canvas.draw(devNull);
+        report("draw-fd", n, secondsSince(start));
+    }
+    close(devNull);
+}
+
+// describes every shape through each printShape form
+static void benchPrintShape() {
+    for (int n = 1000; n <= 1000000; n *= 10) {
+        CanvasList canvas;
+        fill(canvas, n);
+        size_t total = 0;
+
+        auto start = chrono::steady_clock::now();
+        for (ShapeNode *curr = canvas.front(); curr != nullptr; curr = curr->next) {
+            total += curr->value->printShape().size();
+        }
+        report("printShape-string", n, secondsSince(start));
+
+        char buffer[Shape::MAX_TEXT_LENGTH];
+        start = chrono::steady_clock::now();
+        for (ShapeNode *curr = canvas.front(); curr != nullptr; curr = curr->next) {
+            total += curr->value->printShape(buffer, sizeof(buffer));
+        }
+        report("printShape-buffer", n, secondsSince(start));
+
+        string reused;
+        start = chrono::steady_clock::now();
+        for (ShapeNode *curr = canvas.front(); curr != nullptr; curr = curr->next) {
+            reused.clear();
+            total += curr->value->printShape(reused);
+        }
+        report("printShape-reused", n, secondsSince(start));
+        cout << "    characters: " << total << endl;
+    }
+}
+
+// saves and loads canvases through a binary file
+static void benchFile() {
+    const char *path = "/tmp/bench_canvas.bin";
+    for (int n = 10000; n <= 10000000; n *= 10) {
+        CanvasList canvas;
+        fill(canvas, n);
+        double megabytes = (CanvasFile::HEADER_SIZE + (double)n * CanvasFile::RECORD_SIZE) / 1e6;
+
+        auto start = chrono::steady_clock::now();
+        canvas.save(string(path));
+        double seconds = secondsSince(start);
+        report("file-save", n, seconds);
+        cout << "    " << megabytes / seconds << " MB/s" << endl;
+        canvas.clear();
+
+        start = chrono::steady_clock::now();
+        CanvasList loaded;
+        loaded.load(string(path));
+        seconds = secondsSince(start);
+        report("file-load", loaded.size(), seconds);
+        cout << "    " << megabytes / seconds << " MB/s" << endl;
+    }
+    remove(path);
+}
+
+// opens a 10M shape file through the mapped view and through load
+static void benchView() {
+    const char *path = "/tmp/bench_view.bin";
+    const int n = 10000000;
+    {
+        CanvasList canvas;
+        fill(canvas, n);
+        canvas.save(string(path));
+    }
+
+    auto start = chrono::steady_clock::now();
+    CanvasView view;
+    view.open(path);
+    report("view-open", view.size(), secondsSince(start));
+
+    start = chrono::steady_clock::now();
+    ShapeRecord record;
+    long checksum = 0;
+    for (int i = 0; i < 100000; i++) {
+        view.shapeAt(static_cast<int>(i * 2654435761UL % n), record);
+        checksum += record.x;
+    }
+    report("view-shapeAt", 100000, secondsSince(start));
+
+    start = chrono::steady_clock::now();
+    checksum += view.find(-1, -1);
+    report("view-find", n, secondsSince(start));
+
+    NullBuffer nullBuffer;
+    ostream nullStream(&nullBuffer);
+    start = chrono::steady_clock::now();
+    view.draw(nullStream);
+    report("view-draw", n, secondsSince(start));
+
+    start = chrono::steady_clock::now();
+    CanvasList loaded;
+    loaded.load(string(path));
+    report("list-load", loaded.size(), secondsSince(start));
+    cout << "    checksum: " << checksum << endl;
+
+    remove(path);
+}
+
+// rebuilds canvases from draw() text written to a file
+static void benchParse() {
+    const char *path = "/tmp/bench_canvas.txt";
+    for (int n = 10000; n <= 1000000; n *= 10) {
+        {
+            CanvasList canvas;
+            fill(canvas, n);
+            int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            canvas.draw(fd);
+            ::close(fd);
+        }
+        int fd = ::open(path, O_RDONLY);
+        double megabytes = lseek(fd, 0, SEEK_END) / 1e6;
+        ::close(fd);
+
+        auto start = chrono::steady_clock::now();
+        CanvasList parsed;
+        CanvasParser parser;
+        parser.parseFile(path, parsed);
+        double seconds = secondsSince(start);
+        report("parse", parsed.size(), seconds);
+        cout << "    " << megabytes / seconds << " MB/s" << endl;
+    }
+    remove(path);
+}
+
+// compares pointer-per-node shapes with inline variant shapes
+static void benchVariant() {
+    NullBuffer nullBuffer;
+    ostream nullStream(&nullBuffer);
+    for (int n = 1000; n <= 1000000; n *= 10) {
+        auto start = chrono::steady_clock::now();
+        CanvasList list;
+        fill(list, n);
+        report("list-build", n, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        ValueCanvas values;
+        values.reserve(n);
+        for (int i = 0; i < n; i++) {
+            switch (i % 4) {
+                case 0: values.push_back(Shape(i, i)); break;
+                case 1: values.push_back(Circle(i, i, 3)); break;
+                case 2: values.push_back(Rect(i, i, 4, 5)); break;
+                default: values.push_back(RightTriangle(i, i, 6, 7)); break;
+            }
+        }
+        report("value-build", n, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        {
+            CanvasList copy(list);
+            report("list-copy", n, secondsSince(start));
+        }
+        start = chrono::steady_clock::now();
+        {
+            ValueCanvas copy(values);
+            report("value-copy", n, secondsSince(start));
+        }
+
+        start = chrono::steady_clock::now();
+        list.draw(nullStream);
+        report("list-draw", n, secondsSince(start));
+        start = chrono::steady_clock::now();
+        values.draw(nullStream);
+        report("value-draw", n, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        int found = list.find(-1, -1);
+        report("list-find", n, secondsSince(start));
+        start = chrono::steady_clock::now();
+        found += values.find(-1, -1);
+        report("value-find", n, secondsSince(start));
+        cout << "    checksum: " << found << endl;
+    }
+}
+
+// converts a canvas to columns and back, and compares find
+static void benchColumns() {
+    for (int n = 1000; n <= 1000000; n *= 10) {
+        CanvasList list;
+        fill(list, n);
+
+        auto start = chrono::steady_clock::now();
+        ColumnCanvas columns(list);
+        report("columns-from-list", n, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        {
+            CanvasList rebuilt;
+            columns.appendTo(rebuilt);
+            report("columns-to-list", n, secondsSince(start));
+        }
+
+        start = chrono::steady_clock::now();
+        int found = list.find(-1, -1);
+        report("list-find", n, secondsSince(start));
+        start = chrono::steady_clock::now();
+        found += columns.find(-1, -1);
+        report("columns-find", n, secondsSince(start));
+        cout << "    checksum: " << found << endl;
+    }
+}
+
+// pans and zooms a canvas with setters and with each bulk kernel
+static void benchTransform() {
+    for (int n = 1000; n <= 1000000; n *= 10) {
+        CanvasList list;
+        fill(list, n);
+        ColumnCanvas columns(list);
+
+        auto start = chrono::steady_clock::now();
+        for (ShapeNode *curr = list.front(); curr != nullptr; curr = curr->next) {
+            curr->value->setX(curr->value->getX() + 3);
+            curr->value->setY(curr->value->getY() - 2);
+        }
+        report("setter-translate", n, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        for (ShapeNode *curr = list.front(); curr != nullptr; curr = curr->next) {
+            Shape *shape = curr->value;
+            shape->setX(shape->getX() / 2);
+            shape->setY(shape->getY() / 2);
+            switch (shape->getType()) {
+                case SHAPE_CIRCLE: {
+                    Circle *circle = static_cast<Circle *>(shape);
+                    circle->setRadius(circle->getRadius() / 2);
+                    break;
+                }
+                case SHAPE_RECT: {
+                    Rect *rect = static_cast<Rect *>(shape);
+                    rect->setWidth(rect->getWidth() / 2);
+                    rect->setHeight(rect->getHeight() / 2);
+                    break;
+                }
+                case SHAPE_RIGHT_TRIANGLE: {
+                    RightTriangle *triangle = static_cast<RightTriangle *>(shape);
+                    triangle->setBase(triangle->getBase() / 2);
+                    triangle->setHeight(triangle->getHeight() / 2);
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+        report("setter-scale", n, secondsSince(start));
+
+        for (SimdKind kind : {SIMD_SCALAR, SIMD_SSE41, SIMD_AVX2}) {
+            if (kind > SimdLevel::detected()) {
+                continue;
+            }
+            SimdLevel::limit(kind);
+            string name = string("bulk-translate-") + SimdLevel::name(kind);
+            start = chrono::steady_clock::now();
+            BulkTransform::translate(columns, 3, -2);
+            report(name.c_str(), n, secondsSince(start));
+
+            name = string("bulk-scale-") + SimdLevel::name(kind);
+            start = chrono::steady_clock::now();
+            BulkTransform::scale(columns, 0, 0, BulkTransform::ONE / 2);
+            report(name.c_str(), n, secondsSince(start));
+        }
+        SimdLevel::limit(SIMD_AVX2);
+    }
+}
+
+// totals area, perimeter and bounds through virtual calls and each kernel
+static void benchStats() {
+    for (int n = 1000; n <= 1000000; n *= 10) {
+        CanvasList list;
+        scatter(list, n, 100000);
+        ColumnCanvas columns(list);
+
+        auto start = chrono::steady_clock::now();
+        CanvasSummary summary = CanvasStats::summarize(list);
+        report("stats-list", n, secondsSince(start));
+        double checksum = summary.area;
+
+        for (SimdKind kind : {SIMD_SCALAR, SIMD_SSE41, SIMD_AVX2}) {
+            if (kind > SimdLevel::detected()) {
+                continue;
+            }
+            SimdLevel::limit(kind);
+            string name = string("stats-columns-") + SimdLevel::name(kind);
+            start = chrono::steady_clock::now();
+            summary = CanvasStats::summarize(columns);
+            report(name.c_str(), n, secondsSince(start));
+            checksum += summary.perimeter;
+        }
+        SimdLevel::limit(SIMD_AVX2);
+        cout << "    checksum: " << checksum << endl;
+    }
+}
+
+// snapshots a canvas the way an undo stack does: copy, then edit one shape
+static void benchCow() {
+    for (int n = 1000; n <= 1000000; n *= 10) {
+        CanvasList list;
+        fill(list, n);
+        CowCanvas cow(list);
+
+        // the copy-on-write side runs first so it does not pay for the heap
+        // consolidation that freeing a million list shapes leaves behind
+        auto start = chrono::steady_clock::now();
+        {
+            CowCanvas snapshot(cow);
+            report("cow-copy", n, secondsSince(start));
+            cow.editAt(n / 2)->setX(-1);
+            report("cow-snapshot", n, secondsSince(start));
+        }
+
+        start = chrono::steady_clock::now();
+        {
+            CanvasList snapshot(list);
+            list.shapeAt(n / 2)->setX(-1);
+        }
+        report("list-snapshot", n, secondsSince(start));
+    }
+}
+
+// keeps every version of a canvas alive while editing it
+static void benchPersistent() {
+    for (int n = 1000; n <= 1000000; n *= 10) {
+        CanvasList list;
+        fill(list, n);
+        PersistentCanvas canvas(list);
+        vector<PersistentCanvas> history;
+        history.reserve(1000);
+
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < 1000; i++) {
+            history.push_back(canvas);
+            int idx = static_cast<int>(i * 2654435761UL % n);
+            canvas.insertAfter(idx, new Circle(i, i, 1));
+            canvas.removeAt(idx);
+        }
+        report("persistent-edit", 1000, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        long checksum = 0;
+        for (int i = 0; i < 100000; i++) {
+            const PersistentCanvas &version = history[i % history.size()];
+            checksum += version.shapeAt(static_cast<int>(i * 2654435761UL % n))->getX();
+        }
+        report("persistent-shapeAt", 100000, secondsSince(start));
+        cout << "    shapes: " << n << "  height: " << canvas.height() << "  checksum: " << checksum << endl;
+    }
+}
+
+// readers count matches while one writer churns the canvas, first with
+// a CanvasList behind one mutex and then with a ConcurrentCanvas
+static void benchConcurrent() {
+    const int n = 10000;
+    const double seconds = 0.5;
+    for (int readers : {1, 2, 4}) {
+        CanvasList list;
+        mutex listLock;
+        ConcurrentCanvas canvas;
+        for (int i = 0; i < n; i++) {
+            list.push_back(new Circle(i, i, 1));
+            canvas.push_back(new Circle(i, i, 1));
+        }
+
+        for (int mode = 0; mode < 2; mode++) {
+            atomic<bool> stop(false);
+            atomic<long> reads(0);
+            vector<thread> threads;
+            for (int r = 0; r < readers; r++) {
+                threads.emplace_back([&, r] {
+                    long done = 0;
+                    for (int i = r; !stop.load(memory_order_relaxed); i++) {
+                        int x = static_cast<int>(i * 2654435761UL % n);
+                        if (mode == 0) {
+                            lock_guard<mutex> lock(listLock);
+                            list.find(x, x);
+                        }
+                        else {
+                            canvas.find(x, x);
+                        }
+                        done++;
+                    }
+                    reads += done;
+                });
+            }
+            long writes = 0;
+            auto start = chrono::steady_clock::now();
+            while (secondsSince(start) < seconds) {
+                if (mode == 0) {
+                    lock_guard<mutex> lock(listLock);
+                    list.push_back(new Circle(writes, writes, 1));
+                    list.removeAt(0);
+                }
+                else {
+                    canvas.push_back(new Circle(writes, writes, 1));
+                    canvas.removeAt(0);
+                }
+                writes++;
+            }
+            stop = true;
+            for (thread &t : threads) {
+                t.join();
+            }
+            cout << (mode == 0 ? "mutex-list" : "concurrent") << "  readers=" << readers
+                 << "  finds/s=" << reads / seconds << "  writes/s=" << writes / seconds << endl;
+        }
+    }
+}
+
+// producers push shapes to the front, through a mutex around a CanvasList
+// and through the lock-free IngestStack followed by one moveInto
+static void benchIngest() {
+    const int n = 1 << 20;
+    for (int producers = 1; producers <= 32; producers *= 2) {
+        int each = n / producers;
+
+        CanvasList list;
+        mutex listLock;
+        vector<thread> threads;
+        auto start = chrono::steady_clock::now();
+        for (int p = 0; p < producers; p++) {
+            threads.emplace_back([&, p] {
+                for (int i = 0; i < each; i++) {
+                    Shape *shape = i % 2 == 0 ? static_cast<Shape *>(new Circle(p, i, 1)) : new Rect(p, i, 2, 3);
+                    lock_guard<mutex> lock(listLock);
+                    list.push_front(shape);
+                }
+            });
+        }
+        for (thread &t : threads) {
+            t.join();
+        }
+        double seconds = secondsSince(start);
+        cout << "mutex-push_front  producers=" << producers << "  shapes/s=" << list.size() / seconds << endl;
+
+        IngestStack stack;
+        CanvasList ingested;
+        threads.clear();
+        start = chrono::steady_clock::now();
+        for (int p = 0; p < producers; p++) {
+            threads.emplace_back([&, p] {
+                for (int i = 0; i < each; i++) {
+                    stack.push_front(i % 2 == 0 ? static_cast<Shape *>(new Circle(p, i, 1)) : new Rect(p, i, 2, 3));
+                }
+            });
+        }
+        for (thread &t : threads) {
+            t.join();
+        }
+        seconds = secondsSince(start);
+        stack.moveInto(ingested);
+        double withMove = secondsSince(start);
+        cout << "ingest-push_front producers=" << producers << "  shapes/s=" << ingested.size() / seconds
+             << "  with moveInto=" << ingested.size() / withMove << endl;
+    }
+}
+
+// compares find, countIf and draw on one list and on 16 shards
+static void benchShards() {
+    ThreadPool pool;
+    NullBuffer nullBuffer;
+    ostream nullStream(&nullBuffer);
+    for (int n = 10000; n <= 1000000; n *= 10) {
+        CanvasList list;
+        fill(list, n);
+        ShardedCanvas sharded(pool, 16);
+        fill(sharded, n);
+
+        auto start = chrono::steady_clock::now();
+        int found = 0;
+        for (int i = 0; i < 100; i++) {
+            found += list.find(n - 1 - i, n - 1 - i);
+        }
+        report("list-find", 100, secondsSince(start));
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < 100; i++) {
+            found += sharded.find(n - 1 - i, n - 1 - i).index;
+        }
+        report("sharded-find", 100, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        long circles = sharded.countIf([](const Shape &shape) { return shape.getType() == SHAPE_CIRCLE; });
+        report("sharded-countIf", n, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        list.draw(nullStream);
+        report("list-draw", n, secondsSince(start));
+        start = chrono::steady_clock::now();
+        sharded.draw(nullStream);
+        report("sharded-draw", n, secondsSince(start));
+
+        vector<int> sizes = sharded.shardSizes();
+        cout << "    shard sizes " << *min_element(sizes.begin(), sizes.end()) << " to "
+             << *max_element(sizes.begin(), sizes.end()) << "  threads: " << pool.size()
+             << "  checksum: " << found + circles << endl;
+    }
+}
+
+// large copies clone their shapes on a pool instead of one thread
+// at least two workers so the parallel path runs even on one core
+static void benchParallelCopy() {
+    ThreadPool pool(max(2u, thread::hardware_concurrency()));
+    ThreadPool single(1);
+    for (int n = 100000; n <= 1000000; n *= 10) {
+        CanvasList original;
+        fill(original, n);
+
+        // a one-worker pool keeps the copy on this thread
+        auto start = chrono::steady_clock::now();
+        CanvasList serial(original, single, 0);
+        report("copy-serial", n, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        CanvasList shared(original);
+        report("copy-shared-pool", n, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        CanvasList parallel(original, pool, 0);
+        report("copy-parallel", n, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        serial.assignFrom(original, pool, 0);
+        report("assignFrom-parallel", n, secondsSince(start));
+        cout << "    threads: " << pool.size() << endl;
+    }
+}
+
+// predicate searches split the list into ranges scanned on a pool
+static void benchSearch() {
+    ThreadPool pool(max(2u, thread::hardware_concurrency()));
+    CanvasSearch search(pool);
+    for (int n = 100000; n <= 1000000; n *= 10) {
+        CanvasList list;
+        fill(list, n);
+        ShapeFilter filter;
+        filter.types = ShapeFilter::typeBit(SHAPE_RECT) | ShapeFilter::typeBit(SHAPE_CIRCLE);
+        filter.minX = n / 2;
+        filter.minArea = 25.0;
+
+        auto start = chrono::steady_clock::now();
+        long serial = 0;
+        for (ShapeNode *curr = list.front(); curr != nullptr; curr = curr->next) {
+            if (filter(*curr->value)) {
+                serial++;
+            }
+        }
+        report("serial-count", n, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        long counted = search.count(list, filter);
+        report("search-count", n, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        size_t all = search.findAll(list, filter).size();
+        report("search-findAll", n, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        int first = search.findFirst(list, filter);
+        report("search-findFirst", n, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        int found = list.find(n - 1, n - 1);
+        report("list-find-last", n, secondsSince(start));
+        start = chrono::steady_clock::now();
+        int searched = search.findFirst(list, [n](const Shape &shape) { return shape.getX() == n - 1 && shape.getY() == n - 1; });
+        report("search-find-last", n, secondsSince(start));
+
+        cout << "    threads: " << pool.size() << "  checksum: " << serial + counted + all + first + found + searched << endl;
+    }
+}
+
+// bulk removal takes one pass instead of one removeAt walk per index
+static void benchRemove() {
+    for (int n = 10000; n <= 1000000; n *= 10) {
+        vector<int> indices;
+        for (int i = 0; i < n; i += 3) {
+            indices.push_back(i);
+        }
+
+        if (n <= 10000) {
+            CanvasList list;
+            fill(list, n);
+            auto start = chrono::steady_clock::now();
+            for (int i = static_cast<int>(indices.size()) - 1; i >= 0; i--) {
+                list.removeAt(indices[i]);
+            }
+            report("removeAt-loop", n, secondsSince(start));
+        }
+
+        CanvasList list;
+        fill(list, n);
+        auto start = chrono::steady_clock::now();
+        list.removeIndices(indices);
+        report("removeIndices", n, secondsSince(start));
+
+        fill(list, n);
+        start = chrono::steady_clock::now();
+        list.removeIf([](const Shape &shape) { return shape.getType() == SHAPE_CIRCLE; });
+        report("removeIf", n, secondsSince(start));
+
+        fill(list, n);
+        start = chrono::steady_clock::now();
+        list.removeIf([](const Shape &shape) { return shape.getType() == SHAPE_RECT; }, true);
+        report("removeIf-background", n, secondsSince(start));
+        start = chrono::steady_clock::now();
+        list.waitForFrees();
+        report("background-wait", n, secondsSince(start));
+    }
+}
+
+struct Benchmark {
+    const char *name;
+    void (*run)();
+};
+
+static const Benchmark benchmarks[] = {
+    {"push_back", benchPushBack},
+    {"pop_back", benchPopBack},
+    {"copy", benchCopy},
+    {"pool", benchPool},
+    {"layout", benchLayout},
+    {"find", benchFindIndex},
+    {"grid", benchGrid},
+    {"bvh", benchBVH},
+    {"raster", benchRaster},
+    {"tiles", benchTiles},
+    {"draw", benchDraw},
+    {"print", benchPrintShape},
+    {"file", benchFile},
+    {"view", benchView},
+    {"parse", benchParse},
+    {"variant", benchVariant},
+    {"columns", benchColumns},
+    {"transform", benchTransform},
+    {"stats", benchStats},
+    {"cow", benchCow},
+    {"persistent", benchPersistent},
+    {"concurrent", benchConcurrent},
+    {"ingest", benchIngest},
+    {"shards", benchShards},
+    {"pcopy", benchParallelCopy},
+    {"search", benchSearch},
+    {"remove", benchRemove},
+};
+
+int main(int argc, char *argv[]) {
+    for (const Benchmark &b : benchmarks) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], b.name) == 0) {
+                selected = true;
+            }
+        }
+        if (selected) {
+            b.run();
+        }
+    }
+    return 0;
+}
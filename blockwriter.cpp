@@ -0,0 +1,59 @@
+// This file contains all the implementation functions used in blockwriter.h
+// It buffers lines and writes them out a block at a time
+
+#include "blockwriter.h"
+#include <cerrno>
+#include <unistd.h>
+using namespace std;
+
+// Stream constructor : writes blocks to out without flushing it
+BlockWriter::BlockWriter(ostream &out) : out(&out), fd(-1) {
+    buffer.reserve(BLOCK_SIZE + 256);
+}
+
+// File descriptor constructor : writes blocks to an open file descriptor
+BlockWriter::BlockWriter(int fd) : out(nullptr), fd(fd) {
+    buffer.reserve(BLOCK_SIZE + 256);
+}
+
+// Destructor that writes out whatever is still buffered
+BlockWriter::~BlockWriter() {
+    flush();
+}
+
+// returns the buffer to append the current line to
+string& BlockWriter::text() {
+    return buffer;
+}
+
+// ends the current line and writes a block once the buffer holds one
+void BlockWriter::endLine() {
+    buffer.push_back('\n');
+    if (buffer.size() >= BLOCK_SIZE) {
+        flush();
+    }
+}
+
+// writes the buffer to the stream or file descriptor and empties it
+void BlockWriter::flush() {
+    if (out != nullptr) {
+        out->write(buffer.data(), buffer.size());
+    }
+    else {
+        // write may accept only part of a block so loops until it is all out
+        const char *data = buffer.data();
+        size_t length = buffer.size();
+        while (length > 0) {
+            ssize_t written = ::write(fd, data, length);
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                break;
+            }
+            data += written;
+            length -= written;
+        }
+    }
+    buffer.clear();
+}
@@ -0,0 +1,37 @@
+/// @file blockwriter.h
+/// @date October 2, 2023
+/// @brief The blockwriter file contains declarations for the BlockWriter
+///     class that collects lines of text in one reusable buffer and hands
+///     them to an ostream or file descriptor in large blocks.
+
+#pragma once
+
+#include <ostream>
+#include <string>
+
+using namespace std;
+
+// The BlockWriter class is used by the draw functions.
+// Text is appended to text(), each line is closed with endLine(), and
+// whatever is left is written out when the writer is destroyed.
+class BlockWriter
+{
+    private:
+        string buffer;
+        ostream *out;
+        int fd;
+
+        void flush();
+
+    public:
+        static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+        explicit BlockWriter(ostream &);
+        explicit BlockWriter(int fd);
+        BlockWriter(const BlockWriter &) = delete;
+        BlockWriter& operator=(const BlockWriter &) = delete;
+        ~BlockWriter();
+
+        string& text();
+        void endLine();
+};
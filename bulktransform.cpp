@@ -0,0 +1,149 @@
+// This file contains all the implementation functions used in bulktransform.h
+// Kernels for wider instruction sets are compiled with a target attribute
+// so the rest of the program does not need -mavx2
+
+#include "bulktransform.h"
+#include "simdlevel.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BULK_X86 1
+#endif
+using namespace std;
+
+// adds delta to one value, wrapping on overflow
+static inline int addOne(int value, int delta) {
+    return static_cast<int>(static_cast<uint32_t>(value) + static_cast<uint32_t>(delta));
+}
+
+// scales one value's distance from origin by a fixed point factor
+// the difference wraps, the product is exact and rounded down
+static inline int scaleOne(int value, int origin, int32_t factor) {
+    int diff = static_cast<int>(static_cast<uint32_t>(value) - static_cast<uint32_t>(origin));
+    int64_t scaled = (static_cast<int64_t>(diff) * factor) >> BulkTransform::FRACTION_BITS;
+    return addOne(static_cast<int>(static_cast<uint32_t>(scaled)), origin);
+}
+
+// scalar kernel, also used for the tail the vector kernels leave
+static void addScalar(int *values, size_t count, int delta) {
+    for (size_t i = 0; i < count; i++) {
+        values[i] = addOne(values[i], delta);
+    }
+}
+
+// scalar kernel, also used for the tail the vector kernels leave
+static void scaleScalar(int *values, size_t count, int origin, int32_t factor) {
+    for (size_t i = 0; i < count; i++) {
+        values[i] = scaleOne(values[i], origin, factor);
+    }
+}
+
+#ifdef BULK_X86
+
+// adds delta to four values at a time
+__attribute__((target("sse4.1")))
+static void addSSE41(int *values, size_t count, int delta) {
+    __m128i add = _mm_set1_epi32(delta);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i *lane = reinterpret_cast<__m128i *>(values + i);
+        _mm_storeu_si128(lane, _mm_add_epi32(_mm_loadu_si128(lane), add));
+    }
+    addScalar(values + i, count - i, delta);
+}
+
+// scales four values at a time
+// even and odd lanes are multiplied to 64 bits separately; bits 16..47
+// of each product are the wrapped result of shifting it right by 16
+__attribute__((target("sse4.1")))
+static void scaleSSE41(int *values, size_t count, int origin, int32_t factor) {
+    __m128i base = _mm_set1_epi32(origin);
+    __m128i mul = _mm_set1_epi32(factor);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i *lane = reinterpret_cast<__m128i *>(values + i);
+        __m128i diff = _mm_sub_epi32(_mm_loadu_si128(lane), base);
+        __m128i even = _mm_srli_epi64(_mm_mul_epi32(diff, mul), BulkTransform::FRACTION_BITS);
+        __m128i odd = _mm_srli_epi64(_mm_mul_epi32(_mm_srli_epi64(diff, 32), mul),
+                                     BulkTransform::FRACTION_BITS);
+        __m128i result = _mm_blend_epi16(even, _mm_slli_epi64(odd, 32), 0xCC);
+        _mm_storeu_si128(lane, _mm_add_epi32(result, base));
+    }
+    scaleScalar(values + i, count - i, origin, factor);
+}
+
+// adds delta to eight values at a time
+__attribute__((target("avx2")))
+static void addAVX2(int *values, size_t count, int delta) {
+    __m256i add = _mm256_set1_epi32(delta);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i *lane = reinterpret_cast<__m256i *>(values + i);
+        _mm256_storeu_si256(lane, _mm256_add_epi32(_mm256_loadu_si256(lane), add));
+    }
+    addScalar(values + i, count - i, delta);
+}
+
+// scales eight values at a time, the same way scaleSSE41 does
+__attribute__((target("avx2")))
+static void scaleAVX2(int *values, size_t count, int origin, int32_t factor) {
+    __m256i base = _mm256_set1_epi32(origin);
+    __m256i mul = _mm256_set1_epi32(factor);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i *lane = reinterpret_cast<__m256i *>(values + i);
+        __m256i diff = _mm256_sub_epi32(_mm256_loadu_si256(lane), base);
+        __m256i even = _mm256_srli_epi64(_mm256_mul_epi32(diff, mul), BulkTransform::FRACTION_BITS);
+        __m256i odd = _mm256_srli_epi64(_mm256_mul_epi32(_mm256_srli_epi64(diff, 32), mul),
+                                        BulkTransform::FRACTION_BITS);
+        __m256i result = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+        _mm256_storeu_si256(lane, _mm256_add_epi32(result, base));
+    }
+    scaleScalar(values + i, count - i, origin, factor);
+}
+
+#endif
+
+// adds delta to every value using the active kernel
+void BulkTransform::addInts(int *values, size_t count, int delta) {
+#ifdef BULK_X86
+    switch (SimdLevel::active()) {
+        case SIMD_AVX2: addAVX2(values, count, delta); return;
+        case SIMD_SSE41: addSSE41(values, count, delta); return;
+        default: break;
+    }
+#endif
+    addScalar(values, count, delta);
+}
+
+// scales every value's distance from origin using the active kernel
+void BulkTransform::scaleInts(int *values, size_t count, int origin, int32_t factor) {
+#ifdef BULK_X86
+    switch (SimdLevel::active()) {
+        case SIMD_AVX2: scaleAVX2(values, count, origin, factor); return;
+        case SIMD_SSE41: scaleSSE41(values, count, origin, factor); return;
+        default: break;
+    }
+#endif
+    scaleScalar(values, count, origin, factor);
+}
+
+// moves every shape by dx and dy
+void BulkTransform::translate(ColumnCanvas &canvas, int dx, int dy) {
+    for (ShapeType type : {SHAPE_BASIC, SHAPE_CIRCLE, SHAPE_RECT, SHAPE_RIGHT_TRIANGLE}) {
+        ColumnGroup &columns = canvas.group(type);
+        addInts(columns.x.data(), columns.x.size(), dx);
+        addInts(columns.y.data(), columns.y.size(), dy);
+    }
+}
+
+// scales every shape about the point (cx, cy)
+// origins move towards or away from the point and sizes scale with them
+void BulkTransform::scale(ColumnCanvas &canvas, int cx, int cy, int32_t factor) {
+    for (ShapeType type : {SHAPE_BASIC, SHAPE_CIRCLE, SHAPE_RECT, SHAPE_RIGHT_TRIANGLE}) {
+        ColumnGroup &columns = canvas.group(type);
+        scaleInts(columns.x.data(), columns.x.size(), cx, factor);
+        scaleInts(columns.y.data(), columns.y.size(), cy, factor);
+        scaleInts(columns.a.data(), columns.a.size(), 0, factor);
+        scaleInts(columns.b.data(), columns.b.size(), 0, factor);
+    }
+}
@@ -0,0 +1,29 @@
+/// @file bulktransform.h
+/// @date October 2, 2023
+/// @brief The bulktransform file contains declarations for the
+///     BulkTransform class that pans and zooms a whole ColumnCanvas at
+///     once. Each column is updated by an AVX2, SSE4.1 or scalar kernel,
+///     chosen at run time through SimdLevel; all three give identical
+///     results.
+
+#pragma once
+
+#include <cstdint>
+#include "columncanvas.h"
+
+// The BulkTransform class moves and scales every shape in a canvas.
+// Arithmetic wraps around like unsigned ints do. Scale factors are fixed
+// point with FRACTION_BITS fraction bits, so ONE leaves shapes unchanged
+// and ONE / 2 halves them; results are rounded down.
+class BulkTransform
+{
+    public:
+        static constexpr int FRACTION_BITS = 16;
+        static constexpr int32_t ONE = 1 << FRACTION_BITS;
+
+        static void translate(ColumnCanvas &, int dx, int dy);
+        static void scale(ColumnCanvas &, int cx, int cy, int32_t factor);
+
+        static void addInts(int *values, size_t count, int delta);
+        static void scaleInts(int *values, size_t count, int origin, int32_t factor);
+};
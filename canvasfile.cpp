@@ -0,0 +1,118 @@
+// This file contains all the implementation functions used in canvasfile.h
+// It packs and unpacks canvas file headers and shape records
+
+#include "canvasfile.h"
+#include <cstring>
+using namespace std;
+
+static const char MAGIC[4] = {'S', 'H', 'P', 'C'};
+
+// stores value as 4 little endian bytes
+void CanvasFile::writeInt(char *bytes, uint32_t value) {
+    bytes[0] = static_cast<char>(value);
+    bytes[1] = static_cast<char>(value >> 8);
+    bytes[2] = static_cast<char>(value >> 16);
+    bytes[3] = static_cast<char>(value >> 24);
+}
+
+// loads 4 little endian bytes
+uint32_t CanvasFile::readInt(const char *bytes) {
+    const unsigned char *b = reinterpret_cast<const unsigned char *>(bytes);
+    return static_cast<uint32_t>(b[0]) | static_cast<uint32_t>(b[1]) << 8 |
+           static_cast<uint32_t>(b[2]) << 16 | static_cast<uint32_t>(b[3]) << 24;
+}
+
+// fills the 16 byte header for a file holding count shapes
+void CanvasFile::writeHeader(char *bytes, uint64_t count) {
+    memcpy(bytes, MAGIC, 4);
+    writeInt(bytes + 4, VERSION);
+    writeInt(bytes + 8, static_cast<uint32_t>(count));
+    writeInt(bytes + 12, static_cast<uint32_t>(count >> 32));
+}
+
+// reads the shape count from a header
+// returns false if the bytes are not a header this version understands
+bool CanvasFile::readHeader(const char *bytes, uint64_t &count) {
+    if (memcmp(bytes, MAGIC, 4) != 0 || readInt(bytes + 4) != VERSION) {
+        return false;
+    }
+    count = readInt(bytes + 8) | static_cast<uint64_t>(readInt(bytes + 12)) << 32;
+    return true;
+}
+
+// fills the 20 byte record for shape
+void CanvasFile::writeShape(char *record, const Shape &shape) {
+    ShapeRecord fields = ShapeRecord::fromShape(shape);
+    writeInt(record, static_cast<uint32_t>(fields.type));
+    writeInt(record + 4, static_cast<uint32_t>(fields.x));
+    writeInt(record + 8, static_cast<uint32_t>(fields.y));
+    writeInt(record + 12, static_cast<uint32_t>(fields.a));
+    writeInt(record + 16, static_cast<uint32_t>(fields.b));
+}
+
+// unpacks the bytes of a record
+// returns false and leaves out untouched if the type is unknown
+bool CanvasFile::readRecord(const char *record, ShapeRecord &out) {
+    uint32_t type = readInt(record);
+    if (type > SHAPE_RIGHT_TRIANGLE) {
+        return false;
+    }
+    out.type = static_cast<ShapeType>(type);
+    out.x = static_cast<int>(readInt(record + 4));
+    out.y = static_cast<int>(readInt(record + 8));
+    out.a = static_cast<int>(readInt(record + 12));
+    out.b = static_cast<int>(readInt(record + 16));
+    return true;
+}
+
+// builds a new shape from a record
+// returns nullpointer if the type is unknown
+Shape* CanvasFile::readShape(const char *record) {
+    ShapeRecord fields;
+    if (!readRecord(record, fields)) {
+        return nullptr;
+    }
+    return fields.toShape();
+}
+
+// returns the record describing shape
+ShapeRecord ShapeRecord::fromShape(const Shape &shape) {
+    ShapeRecord record{shape.getType(), shape.getX(), shape.getY(), 0, 0};
+    switch (record.type) {
+        case SHAPE_CIRCLE:
+            record.a = static_cast<const Circle &>(shape).getRadius();
+            break;
+        case SHAPE_RECT:
+            record.a = static_cast<const Rect &>(shape).getWidth();
+            record.b = static_cast<const Rect &>(shape).getHeight();
+            break;
+        case SHAPE_RIGHT_TRIANGLE:
+            record.a = static_cast<const RightTriangle &>(shape).getBase();
+            record.b = static_cast<const RightTriangle &>(shape).getHeight();
+            break;
+        default:
+            break;
+    }
+    return record;
+}
+
+// builds a new shape holding the record's fields
+Shape* ShapeRecord::toShape() const {
+    switch (type) {
+        case SHAPE_CIRCLE: return new Circle(x, y, a);
+        case SHAPE_RECT: return new Rect(x, y, a, b);
+        case SHAPE_RIGHT_TRIANGLE: return new RightTriangle(x, y, a, b);
+        default: return new Shape(x, y);
+    }
+}
+
+// appends the text printShape gives for the record's shape
+// the shape lives on the stack so nothing is allocated
+size_t ShapeRecord::printShape(string &out) const {
+    switch (type) {
+        case SHAPE_CIRCLE: return Circle(x, y, a).printShape(out);
+        case SHAPE_RECT: return Rect(x, y, a, b).printShape(out);
+        case SHAPE_RIGHT_TRIANGLE: return RightTriangle(x, y, a, b).printShape(out);
+        default: return Shape(x, y).printShape(out);
+    }
+}
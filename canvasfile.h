@@ -0,0 +1,54 @@
+/// @file canvasfile.h
+/// @date October 2, 2023
+/// @brief The canvasfile file contains declarations for the CanvasFile
+///     class that defines the binary canvas file format. A file is a
+///     16 byte header followed by one fixed size record per shape, all
+///     little endian:
+///
+///         header  "SHPC"  uint32 version  uint64 shape count
+///         record  int32 type  int32 x  int32 y  int32 a  int32 b
+///
+///     a and b hold radius (Circle), width and height (Rect) or base and
+///     height (RightTriangle) and are 0 when unused. Fixed size records
+///     let a reader jump straight to any shape.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "shape.h"
+
+// ShapeRecord struct holds one decoded record without building a Shape
+// a and b are the same extra fields the file stores
+struct ShapeRecord
+{
+    ShapeType type;
+    int x;
+    int y;
+    int a;
+    int b;
+
+    static ShapeRecord fromShape(const Shape &);
+    Shape* toShape() const;
+    size_t printShape(string &out) const;
+};
+
+// The CanvasFile class converts headers and shapes to and from the bytes
+// of a canvas file. It holds no state.
+class CanvasFile
+{
+    public:
+        static constexpr uint32_t VERSION = 1;
+        static constexpr size_t HEADER_SIZE = 16;
+        static constexpr size_t RECORD_SIZE = 20;
+
+        static void writeHeader(char *bytes, uint64_t count);
+        static bool readHeader(const char *bytes, uint64_t &count);
+
+        static void writeShape(char *record, const Shape &);
+        static bool readRecord(const char *record, ShapeRecord &);
+        static Shape* readShape(const char *record);
+
+        static void writeInt(char *bytes, uint32_t value);
+        static uint32_t readInt(const char *bytes);
+};
@@ -2,20 +2,44 @@
 // It allows us to interact with the canvas and classes
 
 #include "canvaslist.h"
+#include "blockwriter.h"
+#include "canvasfile.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <climits>
+#include <fstream>
 #include <iostream>
+#include <vector>
 using namespace std;
 
 // Default constructor : initializes empty canvasList
-CanvasList::CanvasList() : listSize(0), listFront(nullptr) {}
+CanvasList::CanvasList() : listSize(0), listFront(nullptr), listBack(nullptr), findIndex(nullptr), grid(nullptr), positionsStale(false) {}
+
+// returns the pool plain copies of a list with size shapes run on
+// lists below PARALLEL_COPY_MIN, or any list on a single core, get none;
+// the pool is built on first use, which C++ makes safe from any thread,
+// and has one worker per core
+static ThreadPool* sharedCopyPool(int size) {
+    if (size < CanvasList::PARALLEL_COPY_MIN || thread::hardware_concurrency() <= 1) {
+        return nullptr;
+    }
+    static ThreadPool shared;
+    return &shared;
+}
 
 // Copy Constructor : creates new canvasList which is copied from another canvasList
-CanvasList::CanvasList(const CanvasList &copyConst) : listSize(0), listFront(nullptr) {
-    ShapeNode *curr = copyConst.listFront;
-    while (curr != nullptr) {
-        // creates a new shape as the copy and adds it to list
-        push_back(curr->value->copy());
-        curr = curr->next;
-    }
+// the copy has the same indexes as the original
+// large lists are cloned on the shared copy pool
+CanvasList::CanvasList(const CanvasList &copyConst) : CanvasList() {
+    copyIndexesFrom(copyConst);
+    appendCopies(copyConst, sharedCopyPool(copyConst.listSize), PARALLEL_COPY_MIN);
+}
+
+// Parallel copy constructor : like the copy constructor, but clones the shapes
+// on threads when the original has at least minShapes of them
+CanvasList::CanvasList(const CanvasList &copyConst, ThreadPool &threads, int minShapes) : CanvasList() {
+    copyIndexesFrom(copyConst);
+    appendCopies(copyConst, &threads, minShapes);
 }
 
 // Assignment operator : assigns contents of different canvasList to this canvasList
@@ -26,21 +50,107 @@ CanvasList& CanvasList::operator=(const CanvasList &newCopyConst) {
     // clears the current list
     clear();
 
-    ShapeNode *curr = newCopyConst.listFront;
+    // large lists are cloned on the shared copy pool
+    appendCopies(newCopyConst, sharedCopyPool(newCopyConst.listSize), PARALLEL_COPY_MIN);
 
-    while (curr != nullptr) {
+    return *this;
+}
 
-        // creates new shape as a copy and adds it to list
-        push_back(curr->value->copy());
-        curr = curr->next;
+// assigns like operator=, but clones the shapes on threads when the
+// other list has at least minShapes of them
+CanvasList& CanvasList::assignFrom(const CanvasList &other, ThreadPool &threads, int minShapes) {
+    if (this == &other) {
+        return *this;
     }
-
+    clear();
+    appendCopies(other, &threads, minShapes);
     return *this;
 }
 
 // Destructor that deallocates memory for all shapes and nodes in list
+// a background free still running is waited for
 CanvasList::~CanvasList() {
+    waitForFrees();
     clear();
+    delete findIndex;
+    delete grid;
+}
+
+// turns on the same indexes other has
+void CanvasList::copyIndexesFrom(const CanvasList &other) {
+    if (other.hasFindIndex()) {
+        enableFindIndex();
+    }
+    if (other.hasSpatialIndex()) {
+        enableSpatialIndex(other.grid->getCellSize());
+    }
+}
+
+// adds a copy of every shape in source to the back of the list
+// without threads, or below minShapes, it takes the plain push_back loop
+// threads must not be a pool whose tasks copy lists, as run() would deadlock
+void CanvasList::appendCopies(const CanvasList &source, ThreadPool *threads, int minShapes) {
+    if (threads != nullptr && threads->size() > 1 && source.listSize > 0 && source.listSize >= minShapes) {
+        appendCopiesParallel(source, *threads);
+        return;
+    }
+
+    ShapeNode *curr = source.listFront;
+    while (curr != nullptr) {
+        // creates a new shape as the copy and adds it to list
+        // push_back is constant time thanks to the back pointer
+        push_back(curr->value->copy());
+        curr = curr->next;
+    }
+}
+
+// adds a copy of every shape in source by splitting it into ranges
+// the pool is not thread-safe so nodes are handed out up front, then each
+// task clones its range and links its nodes to their known neighbours
+// the chain is stitched onto the back and indexed once every task is done
+void CanvasList::appendCopiesParallel(const CanvasList &source, ThreadPool &threads) {
+    int count = source.listSize;
+    vector<Shape *> shapes;
+    vector<ShapeNode *> nodes;
+    shapes.reserve(count);
+    nodes.reserve(count);
+    for (ShapeNode *curr = source.listFront; curr != nullptr; curr = curr->next) {
+        shapes.push_back(curr->value);
+        nodes.push_back(pool.allocate());
+    }
+
+    long base = listBack != nullptr ? listBack->position + 1 : 0;
+    ShapeNode *before = listBack;
+    int ranges = threads.size() * 4;
+    int rangeSize = (count + ranges - 1) / ranges;
+
+    threads.run(ranges, [&](int range) {
+        int first = range * rangeSize;
+        int last = min(count, first + rangeSize);
+        for (int i = first; i < last; i++) {
+            ShapeNode *node = nodes[i];
+            node->value = shapes[i]->copy();
+            node->value->setObserver(this);
+            node->prev = i > 0 ? nodes[i - 1] : before;
+            node->next = i + 1 < count ? nodes[i + 1] : nullptr;
+            node->position = base + i;
+        }
+    });
+
+    if (before != nullptr) {
+        before->next = nodes.front();
+    }
+    else {
+        listFront = nodes.front();
+    }
+    listBack = nodes.back();
+    listSize += count;
+
+    if (findIndex != nullptr || grid != nullptr) {
+        for (ShapeNode *node : nodes) {
+            attach(node);
+        }
+    }
 }
 
 // clears the list and deallocates memory for all shapes and nodes in lsit
@@ -49,9 +159,127 @@ void CanvasList::clear() {
         ShapeNode *temp = listFront;
         listFront = listFront->next;
         delete temp->value;
-        delete temp;
     }
+
+    // gives all node storage back at once instead of node by node
+    pool.releaseAll();
+    if (findIndex != nullptr) {
+        findIndex->clear();
+    }
+    if (grid != nullptr) {
+        grid->clear();
+    }
+    listBack = nullptr;
     listSize = 0;
+    positionsStale = false;
+}
+
+// returns the node at given index
+// walks from whichever end of the list is closer
+// index must be in range
+ShapeNode* CanvasList::nodeAt(int idx) const {
+    ShapeNode *curr;
+    if (idx < listSize / 2) {
+        curr = listFront;
+        for (int i = 0; i < idx; i++) {
+            curr = curr->next;
+        }
+    }
+    else {
+        curr = listBack;
+        for (int i = listSize - 1; i > idx; i--) {
+            curr = curr->prev;
+        }
+    }
+    return curr;
+}
+
+// detaches node from the list and fixes up its neighbours
+// does not deallocate the node or its shape
+void CanvasList::unlink(ShapeNode *node) {
+    if (node->prev != nullptr) {
+        node->prev->next = node->next;
+    }
+    else {
+        listFront = node->next;
+    }
+
+    if (node->next != nullptr) {
+        node->next->prev = node->prev;
+    }
+    else {
+        listBack = node->prev;
+    }
+
+    listSize--;
+}
+
+// starts observing the node's shape and adds it to the indexes
+void CanvasList::attach(ShapeNode *node) {
+    node->value->setObserver(this);
+    if (findIndex != nullptr) {
+        findIndex->insert(node);
+    }
+    if (grid != nullptr) {
+        grid->insert(node);
+    }
+}
+
+// stops observing the node's shape and removes it from the indexes
+void CanvasList::detach(ShapeNode *node) {
+    if (findIndex != nullptr) {
+        findIndex->remove(node);
+    }
+    if (grid != nullptr) {
+        grid->remove(node);
+    }
+    node->value->setObserver(nullptr);
+}
+
+// gives every node its index as its position
+void CanvasList::renumber() const {
+    long position = 0;
+    for (ShapeNode *curr = listFront; curr != nullptr; curr = curr->next) {
+        curr->position = position;
+        position++;
+    }
+    positionsStale.store(false, memory_order_release);
+}
+
+// renumbers the nodes if a removal left their positions stale
+// const readers can get here at once, so only the first one renumbers
+// and the others wait for it
+void CanvasList::refreshPositions() const {
+    if (!positionsStale.load(memory_order_acquire)) {
+        return;
+    }
+    lock_guard<mutex> lock(renumberLock);
+    if (positionsStale.load(memory_order_relaxed)) {
+        renumber();
+    }
+}
+
+// called by an owned shape after one of its setters ran
+void CanvasList::shapeChanged(Shape *shape, int oldX, int oldY) {
+    if (findIndex != nullptr) {
+        findIndex->move(shape, oldX, oldY);
+    }
+    if (grid != nullptr) {
+        grid->update(shape);
+    }
+}
+
+// turns nodes into their indexes in ascending order
+vector<int> CanvasList::toIndices(const vector<ShapeNode *> &nodes) const {
+    refreshPositions();
+
+    vector<int> indices;
+    indices.reserve(nodes.size());
+    for (ShapeNode *node : nodes) {
+        indices.push_back(static_cast<int>(node->position - listFront->position));
+    }
+    sort(indices.begin(), indices.end());
+    return indices;
 }
 
 
@@ -64,48 +292,51 @@ void CanvasList::insertAfter(int idx, Shape *shape) {
         return;
     }
 
-    listSize++;
-    
+    // inserting after the last node is the same as pushing to the back
+    if (idx == listSize - 1) {
+        push_back(shape);
+        return;
+    }
+
     // creates new node to add to list
-    ShapeNode *newNode = new ShapeNode();
+    ShapeNode *newNode = pool.allocate();
     
     // copies shape pointer into the new node
     newNode->value = shape;
 
-    if (idx == listSize - 1) {      
-        
-        newNode->next = nullptr;
+    // links the new node in between the node at idx and its successor
+    ShapeNode *prevNode = nodeAt(idx);
+    newNode->prev = prevNode;
+    newNode->next = prevNode->next;
+    prevNode->next->prev = newNode;
+    prevNode->next = newNode;
 
-        // finds last node in list
-        ShapeNode *lastNode = listFront;
-        while (lastNode->next != nullptr) {
-            lastNode = lastNode->next;
-        }
+    // every node after the new one moved up an index
+    positionsStale = true;
+    attach(newNode);
 
-        // sets last node's next to point to the new node
-        lastNode->next = newNode;
-    }
-    else {
-        // inserts after any index in range exluding 0
-        ShapeNode *prevNode = listFront;
-        for (int i = 0; i < idx; i++) {
-            prevNode = prevNode->next;
-        }
-        newNode->next = prevNode->next;
-        prevNode->next = newNode;
-    }
+    listSize++;
 }
 
 // pushes shape to front of list
 void CanvasList::push_front(Shape *shape) {
     
     // creates new node and sets value
-    ShapeNode *newNode = new ShapeNode();
+    ShapeNode *newNode = pool.allocate();
     newNode->value = shape;
+    newNode->prev = nullptr;
 
     // sets the new node as the head of linked list
     newNode->next = listFront;
+    if (listFront != nullptr) {
+        newNode->position = listFront->position - 1;
+        listFront->prev = newNode;
+    }
+    else {
+        listBack = newNode;
+    }
     listFront = newNode;
+    attach(newNode);
 
     // increments the list size
     listSize++;
@@ -115,22 +346,22 @@ void CanvasList::push_front(Shape *shape) {
 void CanvasList::push_back(Shape *shape) {
 
     // creates new node
-    ShapeNode *newNode = new ShapeNode();
+    ShapeNode *newNode = pool.allocate();
     newNode->value = shape;
     newNode->next = nullptr;
+    newNode->prev = listBack;
 
     // if the list is empty the new node is now the front of the list
     if (isempty()) {
         listFront = newNode;
     }
     else {
-        // finds last node in last and makes it the new node
-        ShapeNode *lastNode = listFront;
-        while (lastNode->next != nullptr) {
-            lastNode = lastNode->next;
-        }
-        lastNode->next = newNode;
+        // links the new node after the current last node
+        newNode->position = listBack->position + 1;
+        listBack->next = newNode;
     }
+    listBack = newNode;
+    attach(newNode);
 
     // increments list size
     listSize++;
@@ -143,72 +374,101 @@ void CanvasList::removeAt(int idx) {
         return;
     }
 
-    if (idx == 0) {
-        // creates temp at front of list
-        ShapeNode *temp = listFront;
-
-        // sets front of list to the 2nd node
-        listFront = listFront->next;
-
-        // // deallocates memory for first node
-        delete temp->value;
-        delete temp;
+    // every node after a removed middle node moved down an index
+    if (idx != 0 && idx != listSize - 1) {
+        positionsStale = true;
     }
-    else {
 
-        // gets front node
-        ShapeNode *prevNode = front();
+    // finds the node and detaches it from its neighbours
+    ShapeNode *temp = nodeAt(idx);
+    detach(temp);
+    unlink(temp);
 
-        // traverse through node
-        for (int i = 0; i < idx - 1; i++) {
-            prevNode = prevNode->next;
-        }
+    // deallocates memory for removed node
+    delete temp->value;
+    pool.release(temp);
+}
+
+// removes every other shape in list
+// first removal is index 1
+void CanvasList::removeEveryOther() {
+    removeWhere([](int idx, const Shape &) { return idx % 2 != 0; }, false);
+}
 
-        // stores node to delete
-        ShapeNode *temp = prevNode->next;
+// removes every shape that passes test in one pass over the list
+// returns the number of shapes removed
+int CanvasList::removeIf(const function<bool(const Shape &)> &test, bool freeInBackground) {
+    return removeWhere([&](int, const Shape &shape) { return test(shape); }, freeInBackground);
+}
 
-        // updates previous node's next pointer
-        prevNode->next = temp->next;
+// removes the shapes at the given indices in one pass over the list
+// indices must be in increasing order, repeats and out of range ones are
+// ignored and returns the number of shapes removed
+int CanvasList::removeIndices(const vector<int> &sorted, bool freeInBackground) {
+    auto next = lower_bound(sorted.begin(), sorted.end(), 0);
+    return removeWhere([&](int idx, const Shape &) {
+        while (next != sorted.end() && *next < idx) {
+            next++;
+        }
+        return next != sorted.end() && *next == idx;
+    }, freeInBackground);
+}
 
-        // deallocates memory for removed node
-        delete temp->value;
-        delete temp;
+// waits until every shape handed to a background free is deleted
+void CanvasList::waitForFrees() {
+    if (freeing.valid()) {
+        freeing.wait();
     }
-    listSize--;
 }
 
-// removes every other shape in list
-// first removal is index 1
-void CanvasList::removeEveryOther() {
-    // starts beginning node at the front of the list
+// unlinks every node whose original index and shape pass test, then frees
+// the removed shapes; the nodes go straight back to the pool
+// returns the number of shapes removed
+int CanvasList::removeWhere(const function<bool(int, const Shape &)> &test, bool freeInBackground) {
+    vector<Shape *> removed;
     ShapeNode *curr = listFront;
-    ShapeNode *prev = nullptr;
-
     int idx = 0;
 
     while (curr != nullptr) {
+        ShapeNode *next = curr->next;
 
-        // handles every other node starting at index 1
-        if (idx % 2 != 0) {
-            if (prev != nullptr) {
-                prev->next = curr->next;
+        if (test(idx, *curr->value)) {
+            // later nodes only move down an index if a node stays before them
+            if (curr->prev != nullptr && curr->next != nullptr) {
+                positionsStale = true;
             }
-            else {
-                listFront = curr->next;
-            }
-            ShapeNode *temp = curr;
-            curr = curr->next;
-            delete temp->value;
-            delete temp;
-            listSize--;
-        }
-        else {
-            prev = curr;
-            curr = curr->next;
+            detach(curr);
+            unlink(curr);
+            removed.push_back(curr->value);
+            pool.release(curr);
         }
 
+        curr = next;
         idx++;
     }
+
+    int count = static_cast<int>(removed.size());
+    freeShapes(move(removed), freeInBackground);
+    return count;
+}
+
+// deletes shapes that are no longer in the list
+// large batches can be deleted on a background thread; only one batch is
+// in flight at a time and the destructor waits for it
+void CanvasList::freeShapes(vector<Shape *> &&shapes, bool freeInBackground) {
+    if (!freeInBackground || shapes.size() < static_cast<size_t>(BACKGROUND_FREE_MIN)) {
+        for (Shape *shape : shapes) {
+            delete shape;
+        }
+        return;
+    }
+
+    waitForFrees();
+    freeing = async(launch::async, [batch = move(shapes)]() {
+        for (Shape *shape : batch) {
+            delete shape;
+        }
+    });
 }
 
 // pops and returns the front of list shape
@@ -225,12 +485,12 @@ Shape* CanvasList::pop_front() {
     Shape *shape = temp->value;
 
     // starts list on 2nd node
-    listFront = listFront->next;
+    // the caller owns the shape again so it is no longer observed
+    detach(temp);
+    unlink(temp);
 
     // deallocates memory for the 1st node
-    delete temp;
-
-    listSize--;
+    pool.release(temp);
 
     return shape;
 }
@@ -240,33 +500,22 @@ Shape* CanvasList::pop_front() {
 // returns pointer to shape if list is 1
 Shape* CanvasList::pop_back() {
 
-
     // checks if list is empty
     if (isempty()) {
         return nullptr;
     }
 
-    if (listSize == 1) {
-        ShapeNode *temp = listFront;
-        listFront = nullptr;
-        Shape *shape = temp->value;
-        delete temp;
-        listSize--;
-        return shape;
-    }
+    // stores node and value of the back node
+    ShapeNode *temp = listBack;
+    Shape *shape = temp->value;
 
-    ShapeNode *curr = listFront;
-    ShapeNode *prev = nullptr;
-    while (curr->next != nullptr) {
-        prev = curr;
-        curr = curr->next;
-    }
+    // ends list on the 2nd to last node
+    // the caller owns the shape again so it is no longer observed
+    detach(temp);
+    unlink(temp);
 
-    // stores value of shape
-    prev->next = nullptr;
-    Shape *shape = curr->value;
-    delete curr;
-    listSize--;
+    // deallocates memory for the last node
+    pool.release(temp);
 
     return shape;
 }
@@ -276,6 +525,11 @@ ShapeNode* CanvasList::front() const {
     return listFront;
 }
 
+// returns back node of list
+ShapeNode* CanvasList::back() const {
+    return listBack;
+}
+
 // checks if list is empty
 bool CanvasList::isempty() const {
     return listSize == 0;
@@ -290,6 +544,16 @@ int CanvasList::size() const {
 // returns -1 if shape not found
 // return index if shape is found
 int CanvasList::find(int x, int y) const {
+
+    // answers from the hash index when there is one
+    if (findIndex != nullptr) {
+        refreshPositions();
+        ShapeNode *node = findIndex->first(x, y);
+        if (node == nullptr) {
+            return -1;
+        }
+        return static_cast<int>(node->position - listFront->position);
+    }
     
     // starts current node at front of list
     ShapeNode *curr = listFront;
@@ -316,27 +580,33 @@ Shape* CanvasList::shapeAt(int idx) const {
         return nullptr;
     }
     
-    // starts current node at front
-    ShapeNode *curr = listFront;
-
-    // traverses through list to find node at given index
-    for (int i = 0; i < idx; i++) {
-        curr = curr->next;
-    }
-
     // returns pointer to shape at given index
-    return curr->value;
+    return nodeAt(idx)->value;
 
 }
 
-// draws all shapes in list
+// draws all shapes in list to the console
 void CanvasList::draw() const {
-    ShapeNode *curr = listFront;
+    draw(cout);
+    cout.flush();
+}
 
-    while (curr != nullptr) {
-        // calls printShape function for each shape to get shape's info
-        cout << curr->value->printShape() << endl;
-        curr = curr->next;
+// draws all shapes in list to out, one printShape line per shape
+// lines are written in large blocks and out is not flushed
+void CanvasList::draw(ostream &out) const {
+    BlockWriter writer(out);
+    for (ShapeNode *curr = listFront; curr != nullptr; curr = curr->next) {
+        curr->value->printShape(writer.text());
+        writer.endLine();
+    }
+}
+
+// draws all shapes in list to an open file descriptor
+void CanvasList::draw(int fd) const {
+    BlockWriter writer(fd);
+    for (ShapeNode *curr = listFront; curr != nullptr; curr = curr->next) {
+        curr->value->printShape(writer.text());
+        writer.endLine();
     }
 }
 
@@ -345,7 +615,166 @@ void CanvasList::printAddresses() const {
     ShapeNode *curr = listFront;
     while (curr != nullptr) {
         // prints out pointer address and the pointer's value(shape) address
-        cout << "Node Address: " << curr << "    Shape Address: " << curr->value << endl;
+        cout << "Node Address: " << curr << "    Shape Address: " << curr->value << '\n';
         curr = curr->next;
     }
+    cout.flush();
+}
+
+// number of shape records moved to or from a stream at a time
+static const size_t FILE_BLOCK_RECORDS = 4096;
+
+// writes every shape in list to out in the canvas file format
+// returns false if out failed
+bool CanvasList::save(ostream &out) const {
+    char header[CanvasFile::HEADER_SIZE];
+    CanvasFile::writeHeader(header, listSize);
+    out.write(header, sizeof(header));
+
+    vector<char> block(FILE_BLOCK_RECORDS * CanvasFile::RECORD_SIZE);
+    size_t used = 0;
+    for (ShapeNode *curr = listFront; curr != nullptr; curr = curr->next) {
+        CanvasFile::writeShape(block.data() + used, *curr->value);
+        used += CanvasFile::RECORD_SIZE;
+        if (used == block.size()) {
+            out.write(block.data(), used);
+            used = 0;
+        }
+    }
+    out.write(block.data(), used);
+    return static_cast<bool>(out);
+}
+
+// writes every shape in list to a new file at path
+// returns false if the file could not be written
+bool CanvasList::save(const string &path) const {
+    ofstream out(path, ios::binary);
+    return out && save(out);
+}
+
+// replaces the shapes in list with the ones read from in
+// returns false and leaves the list empty if in is not a valid canvas file
+bool CanvasList::load(istream &in) {
+    clear();
+
+    char header[CanvasFile::HEADER_SIZE];
+    uint64_t count;
+    if (!in.read(header, sizeof(header)) || !CanvasFile::readHeader(header, count) || count > INT_MAX) {
+        return false;
+    }
+
+    vector<char> block(FILE_BLOCK_RECORDS * CanvasFile::RECORD_SIZE);
+    while (count > 0) {
+        size_t records = min<uint64_t>(count, FILE_BLOCK_RECORDS);
+        if (!in.read(block.data(), records * CanvasFile::RECORD_SIZE)) {
+            clear();
+            return false;
+        }
+        for (size_t i = 0; i < records; i++) {
+            Shape *shape = CanvasFile::readShape(block.data() + i * CanvasFile::RECORD_SIZE);
+            if (shape == nullptr) {
+                clear();
+                return false;
+            }
+            push_back(shape);
+        }
+        count -= records;
+    }
+    return true;
+}
+
+// replaces the shapes in list with the ones in the file at path
+// returns false and leaves the list empty if the file is missing or invalid
+bool CanvasList::load(const string &path) {
+    ifstream in(path, ios::binary);
+    if (!in) {
+        clear();
+        return false;
+    }
+    return load(in);
+}
+
+// returns the node allocation counters for this list
+PoolStats CanvasList::poolStats() const {
+    return pool.getStats();
+}
+
+// builds a hash index from shape origins to nodes
+// find() uses it from then on and every change keeps it up to date
+void CanvasList::enableFindIndex() {
+    if (findIndex != nullptr) {
+        return;
+    }
+    findIndex = new CoordIndex();
+    for (ShapeNode *curr = listFront; curr != nullptr; curr = curr->next) {
+        findIndex->insert(curr);
+    }
+}
+
+// drops the hash index so find() goes back to walking the list
+void CanvasList::disableFindIndex() {
+    delete findIndex;
+    findIndex = nullptr;
+}
+
+// checks if find() is answered from the hash index
+bool CanvasList::hasFindIndex() const {
+    return findIndex != nullptr;
+}
+
+// builds a grid over the bounds of every shape
+// shapesAt() and shapesIn() use it from then on and every change keeps it up to date
+void CanvasList::enableSpatialIndex(int cellSize) {
+    if (grid != nullptr) {
+        return;
+    }
+    grid = new SpatialGrid(cellSize);
+    for (ShapeNode *curr = listFront; curr != nullptr; curr = curr->next) {
+        grid->insert(curr);
+    }
+}
+
+// drops the grid so area queries go back to walking the list
+void CanvasList::disableSpatialIndex() {
+    delete grid;
+    grid = nullptr;
+}
+
+// checks if area queries are answered from the grid
+bool CanvasList::hasSpatialIndex() const {
+    return grid != nullptr;
+}
+
+// returns the indexes of every shape covering px,py in ascending order
+// the last index is the shape drawn on top
+vector<int> CanvasList::shapesAt(int px, int py) const {
+    vector<ShapeNode *> nodes;
+    if (grid != nullptr) {
+        grid->queryPoint(px, py, nodes);
+    }
+    else {
+        for (ShapeNode *curr = listFront; curr != nullptr; curr = curr->next) {
+            if (curr->value->contains(px, py)) {
+                nodes.push_back(curr);
+            }
+        }
+    }
+    return toIndices(nodes);
+}
+
+// returns the indexes of every shape whose bounds overlap area in ascending order
+vector<int> CanvasList::shapesIn(const Bounds &area) const {
+    vector<ShapeNode *> nodes;
+    if (grid != nullptr) {
+        grid->queryRect(area, nodes);
+    }
+    else {
+        for (ShapeNode *curr = listFront; curr != nullptr; curr = curr->next) {
+            Bounds b = curr->value->getBounds();
+            if (b.maxX >= area.minX && b.minX <= area.maxX && b.maxY >= area.minY && b.minY <= area.maxY) {
+                nodes.push_back(curr);
+            }
+        }
+    }
+    return toIndices(nodes);
 }
@@ -10,31 +10,80 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <future>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
 #include "shape.h"
+#include "nodepool.h"
+#include "coordindex.h"
+#include "spatialgrid.h"
 
 using namespace std;
 
+class ThreadPool;
+
 // ShapeNode class used as nodes in linked list
 // implemented akin to a struct as all data is public
+// position only ever grows from front to back, it equals the node's
+// index minus the front node's position unless the list marked it stale
 class ShapeNode
 {
     public:
         Shape *value;
         ShapeNode *next;
+        ShapeNode *prev;
+        long position;
 };
 
 // The CanvasList class implements the functionality of a linked list.
 // This linked list can contain all types of Shape and its derived classes.
-class CanvasList
+// The list observes the shapes it owns so optional indexes stay correct
+// when a shape is moved through its setters.
+// Copies of large lists clone their shapes on a shared pool with one
+// worker per core, or on a ThreadPool given to the copy.
+// Const functions may run on several threads at once as long as no
+// thread modifies the list meanwhile.
+class CanvasList : private ShapeObserver
 {
     private:
         int listSize;
         ShapeNode *listFront;
+        ShapeNode *listBack;
+        NodePool pool;
+        CoordIndex *findIndex;
+        SpatialGrid *grid;
+        mutable atomic<bool> positionsStale;
+        mutable mutex renumberLock;
+        future<void> freeing;
+
+        ShapeNode* nodeAt(int) const;
+        void unlink(ShapeNode *);
+        void attach(ShapeNode *);
+        void detach(ShapeNode *);
+        void renumber() const;
+        void refreshPositions() const;
+        void shapeChanged(Shape *, int oldX, int oldY) override;
+        vector<int> toIndices(const vector<ShapeNode *> &) const;
+        void copyIndexesFrom(const CanvasList &);
+        void appendCopies(const CanvasList &, ThreadPool *, int minShapes);
+        void appendCopiesParallel(const CanvasList &, ThreadPool &);
+        int removeWhere(const function<bool(int, const Shape &)> &, bool freeInBackground);
+        void freeShapes(vector<Shape *> &&, bool freeInBackground);
 
     public:
+        static constexpr int PARALLEL_COPY_MIN = 1 << 16;
+        static constexpr int BACKGROUND_FREE_MIN = 1024;
+
         CanvasList();
         CanvasList(const CanvasList &);
+        CanvasList(const CanvasList &, ThreadPool &, int minShapes = PARALLEL_COPY_MIN);
         CanvasList& operator=(const CanvasList &);
+        CanvasList& assignFrom(const CanvasList &, ThreadPool &, int minShapes = PARALLEL_COPY_MIN);
         
         virtual ~CanvasList();
         void clear();
@@ -45,10 +94,14 @@ class CanvasList
         
         void removeAt(int);
         void removeEveryOther();
+        int removeIf(const function<bool(const Shape &)> &, bool freeInBackground = false);
+        int removeIndices(const vector<int> &sorted, bool freeInBackground = false);
+        void waitForFrees();
         Shape* pop_front();
         Shape* pop_back();
 
         ShapeNode* front() const;
+        ShapeNode* back() const;
         bool isempty() const;
         int size() const;
 
@@ -56,5 +109,24 @@ class CanvasList
         Shape* shapeAt(int) const;
         
         void draw() const;
+        void draw(ostream &) const;
+        void draw(int fd) const;
         void printAddresses() const;
+
+        bool save(ostream &) const;
+        bool save(const string &path) const;
+        bool load(istream &);
+        bool load(const string &path);
+
+        PoolStats poolStats() const;
+
+        void enableFindIndex();
+        void disableFindIndex();
+        bool hasFindIndex() const;
+
+        void enableSpatialIndex(int cellSize = 64);
+        void disableSpatialIndex();
+        bool hasSpatialIndex() const;
+        vector<int> shapesAt(int px, int py) const;
+        vector<int> shapesIn(const Bounds &area) const;
 };
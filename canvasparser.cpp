@@ -0,0 +1,222 @@
+// This file contains all the implementation functions used in canvasparser.h
+// It splits input into lines and matches each against the printShape formats
+
+#include "canvasparser.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+using namespace std;
+
+namespace {
+
+// LineCursor struct walks one line, matching fixed text and numbers
+struct LineCursor
+{
+    const char *pos;
+    const char *end;
+
+    template <size_t N>
+    bool expect(const char (&literal)[N]) {
+        if (static_cast<size_t>(end - pos) < N - 1 || memcmp(pos, literal, N - 1) != 0) {
+            return false;
+        }
+        pos += N - 1;
+        return true;
+    }
+
+    bool number(int &value) {
+        from_chars_result result = from_chars(pos, end, value);
+        if (result.ec != errc() || result.ptr == pos) {
+            return false;
+        }
+        pos = result.ptr;
+        return true;
+    }
+
+    bool done() const {
+        return pos == end;
+    }
+};
+
+}
+
+// Parameter constructor : reads input chunkSize bytes at a time
+CanvasParser::CanvasParser(size_t chunkSize) : chunkSize(chunkSize == 0 ? 1 : chunkSize), lineNumber(0), shapeCount(0), errorCount(0) {}
+
+// builds a new shape from one printShape line without its newline
+// returns nullpointer if the line is not in any printShape format
+Shape* CanvasParser::parseShape(const char *begin, const char *end) {
+    LineCursor line{begin, end};
+    int x;
+    int y;
+    int a;
+    int b;
+
+    if (!line.expect("It's a ")) {
+        return nullptr;
+    }
+    if (line.expect("Circle at x: ")) {
+        if (line.number(x) && line.expect(", y: ") && line.number(y) && line.expect(", radius: ") &&
+            line.number(a) && line.done()) {
+            return new Circle(x, y, a);
+        }
+    }
+    else if (line.expect("Rectangle at x: ")) {
+        if (line.number(x) && line.expect(", y: ") && line.number(y) && line.expect(" with width: ") &&
+            line.number(a) && line.expect(" and height: ") && line.number(b) && line.done()) {
+            return new Rect(x, y, a, b);
+        }
+    }
+    else if (line.expect("Right Triangle at x: ")) {
+        if (line.number(x) && line.expect(", y: ") && line.number(y) && line.expect(" with base: ") &&
+            line.number(a) && line.expect(" and height: ") && line.number(b) && line.done()) {
+            return new RightTriangle(x, y, a, b);
+        }
+    }
+    else if (line.expect("Shape at x: ")) {
+        if (line.number(x) && line.expect(", y: ") && line.number(y) && line.done()) {
+            return new Shape(x, y);
+        }
+    }
+    return nullptr;
+}
+
+// appends the shape on one line to canvas or records an error
+void CanvasParser::parseLine(const char *begin, const char *end, CanvasList &canvas) {
+    lineNumber++;
+
+    // accepts files written with windows line endings
+    if (end > begin && end[-1] == '\r') {
+        end--;
+    }
+    if (begin == end) {
+        return;
+    }
+
+    Shape *shape = parseShape(begin, end);
+    if (shape != nullptr) {
+        canvas.push_back(shape);
+        shapeCount++;
+        return;
+    }
+
+    errorCount++;
+    if (errors.size() < MAX_ERRORS) {
+        errors.push_back(ParseError{lineNumber, string(begin, end)});
+    }
+}
+
+// parses every complete line in data
+// a line cut off at the end is kept until the next chunk arrives
+void CanvasParser::feed(const char *data, size_t length, CanvasList &canvas) {
+    const char *pos = data;
+    const char *end = data + length;
+
+    // finishes the line left over from the previous chunk
+    if (!pending.empty()) {
+        const char *newline = static_cast<const char *>(memchr(pos, '\n', length));
+        if (newline == nullptr) {
+            pending.append(pos, end);
+            return;
+        }
+        pending.append(pos, newline);
+        parseLine(pending.data(), pending.data() + pending.size(), canvas);
+        pending.clear();
+        pos = newline + 1;
+    }
+
+    while (pos < end) {
+        const char *newline = static_cast<const char *>(memchr(pos, '\n', end - pos));
+        if (newline == nullptr) {
+            pending.assign(pos, end);
+            return;
+        }
+        parseLine(pos, newline, canvas);
+        pos = newline + 1;
+    }
+}
+
+// parses a last line that had no newline after it
+void CanvasParser::finish(CanvasList &canvas) {
+    if (!pending.empty()) {
+        parseLine(pending.data(), pending.data() + pending.size(), canvas);
+        pending.clear();
+    }
+}
+
+// forgets the counts and errors of the previous parse
+void CanvasParser::reset() {
+    pending.clear();
+    lineNumber = 0;
+    shapeCount = 0;
+    errorCount = 0;
+    errors.clear();
+}
+
+// appends the shapes described in text to canvas
+// returns false if any line was malformed
+bool CanvasParser::parse(const string &text, CanvasList &canvas) {
+    reset();
+    for (size_t start = 0; start < text.size(); start += chunkSize) {
+        feed(text.data() + start, min(chunkSize, text.size() - start), canvas);
+    }
+    finish(canvas);
+    return errorCount == 0;
+}
+
+// appends the shapes read from an open file descriptor, such as 0 for stdin
+// returns false if any line was malformed or reading failed
+bool CanvasParser::parse(int fd, CanvasList &canvas) {
+    reset();
+    vector<char> chunk(chunkSize);
+    bool ok = true;
+    while (true) {
+        ssize_t got = ::read(fd, chunk.data(), chunk.size());
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            ok = got == 0;
+            break;
+        }
+        feed(chunk.data(), static_cast<size_t>(got), canvas);
+    }
+    finish(canvas);
+    return ok && errorCount == 0;
+}
+
+// appends the shapes described in the file at path
+// returns false if the file could not be read or any line was malformed
+bool CanvasParser::parseFile(const string &path, CanvasList &canvas) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        reset();
+        return false;
+    }
+    bool ok = parse(fd, canvas);
+    ::close(fd);
+    return ok;
+}
+
+// returns the number of shapes appended by the last parse
+long CanvasParser::shapesRead() const {
+    return shapeCount;
+}
+
+// returns the number of lines seen by the last parse
+long CanvasParser::linesRead() const {
+    return lineNumber;
+}
+
+// returns the number of malformed lines in the last parse
+long CanvasParser::errorTotal() const {
+    return errorCount;
+}
+
+// returns the first MAX_ERRORS malformed lines of the last parse
+const vector<ParseError>& CanvasParser::getErrors() const {
+    return errors;
+}
@@ -0,0 +1,58 @@
+/// @file canvasparser.h
+/// @date October 2, 2023
+/// @brief The canvasparser file contains declarations for the CanvasParser
+///     class that rebuilds a CanvasList from the text draw() writes.
+///     Input is read in fixed size chunks and numbers are read with
+///     from_chars, so large logs load at close to disk speed.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "canvaslist.h"
+
+using namespace std;
+
+// ParseError struct records one line that was not a printShape line
+struct ParseError
+{
+    long line;
+    string text;
+};
+
+// The CanvasParser class appends one shape to a CanvasList for every
+// printShape line it reads. Blank lines are skipped; any other line is
+// reported as a ParseError and skipped. Only the first MAX_ERRORS errors
+// are kept but all of them are counted.
+class CanvasParser
+{
+    private:
+        size_t chunkSize;
+        string pending;
+        long lineNumber;
+        long shapeCount;
+        long errorCount;
+        vector<ParseError> errors;
+
+        void parseLine(const char *begin, const char *end, CanvasList &);
+        void feed(const char *data, size_t length, CanvasList &);
+        void finish(CanvasList &);
+        void reset();
+
+    public:
+        static constexpr size_t DEFAULT_CHUNK_SIZE = 1 << 20;
+        static constexpr size_t MAX_ERRORS = 100;
+
+        explicit CanvasParser(size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+        bool parse(const string &text, CanvasList &);
+        bool parse(int fd, CanvasList &);
+        bool parseFile(const string &path, CanvasList &);
+
+        static Shape* parseShape(const char *begin, const char *end);
+
+        long shapesRead() const;
+        long linesRead() const;
+        long errorTotal() const;
+        const vector<ParseError>& getErrors() const;
+};
@@ -0,0 +1,123 @@
+// This file contains all the implementation functions used in canvassearch.h
+// Each range is a run of consecutive nodes scanned by one pool task
+
+#include "canvassearch.h"
+#include <algorithm>
+#include <atomic>
+using namespace std;
+
+// returns the bit of types that accepts the given type
+unsigned ShapeFilter::typeBit(ShapeType type) {
+    return 1u << type;
+}
+
+// returns true if the shape is of an accepted type, its anchor point is
+// inside the coordinate ranges and its area is inside the area range
+// the cheap tests run first so the virtual getArea call is often skipped
+bool ShapeFilter::operator()(const Shape &shape) const {
+    if ((types & typeBit(shape.getType())) == 0) {
+        return false;
+    }
+    int x = shape.getX();
+    int y = shape.getY();
+    if (x < minX || x > maxX || y < minY || y > maxY) {
+        return false;
+    }
+    double area = shape.getArea();
+    return area >= minArea && area <= maxArea;
+}
+
+// constructor : searches run on the given pool, in ranges of at least
+// minRange nodes
+CanvasSearch::CanvasSearch(ThreadPool &threads, int minRange) : pool(threads), minRange(max(1, minRange)) {}
+
+// calls task(range, first node, index of first node, node count) for
+// consecutive ranges covering the list, at most four per worker
+// the range starts are found in one walk before the ranges are handed out
+void CanvasSearch::forEachRange(const CanvasList &list, const function<void(int, ShapeNode *, int, int)> &task) const {
+    int size = list.size();
+    if (size == 0) {
+        return;
+    }
+    int ranges = min(pool.size() * 4, (size + minRange - 1) / minRange);
+    if (ranges <= 1) {
+        task(0, list.front(), 0, size);
+        return;
+    }
+
+    int rangeSize = (size + ranges - 1) / ranges;
+    ranges = (size + rangeSize - 1) / rangeSize;
+    vector<ShapeNode *> starts;
+    starts.reserve(ranges);
+    int idx = 0;
+    for (ShapeNode *curr = list.front(); curr != nullptr; curr = curr->next) {
+        if (idx % rangeSize == 0) {
+            starts.push_back(curr);
+        }
+        idx++;
+    }
+
+    pool.run(ranges, [&](int range) {
+        int first = range * rangeSize;
+        task(range, starts[range], first, min(rangeSize, size - first));
+    });
+}
+
+// returns the index of the first shape passing test, or -1 if none does
+// a range stops scanning once an earlier index has been found
+int CanvasSearch::findFirst(const CanvasList &list, const ShapeTest &test) const {
+    atomic<int> best(INT_MAX);
+    forEachRange(list, [&](int, ShapeNode *curr, int first, int count) {
+        for (int idx = first; idx < first + count; idx++, curr = curr->next) {
+            if (idx >= best.load(memory_order_relaxed)) {
+                return;
+            }
+            if (test(*curr->value)) {
+                int seen = best.load(memory_order_relaxed);
+                while (idx < seen && !best.compare_exchange_weak(seen, idx, memory_order_relaxed)) {
+                }
+                return;
+            }
+        }
+    });
+    int found = best.load();
+    return found == INT_MAX ? -1 : found;
+}
+
+// returns the indices of every shape passing test in increasing order
+vector<int> CanvasSearch::findAll(const CanvasList &list, const ShapeTest &test) const {
+    vector<vector<int>> found(pool.size() * 4 + 1);
+    forEachRange(list, [&](int range, ShapeNode *curr, int first, int count) {
+        for (int idx = first; idx < first + count; idx++, curr = curr->next) {
+            if (test(*curr->value)) {
+                found[range].push_back(idx);
+            }
+        }
+    });
+
+    vector<int> indices;
+    for (const vector<int> &part : found) {
+        indices.insert(indices.end(), part.begin(), part.end());
+    }
+    return indices;
+}
+
+// returns how many shapes pass test
+long CanvasSearch::count(const CanvasList &list, const ShapeTest &test) const {
+    vector<long> counts(pool.size() * 4 + 1, 0);
+    forEachRange(list, [&](int range, ShapeNode *curr, int first, int count) {
+        long matches = 0;
+        for (int idx = first; idx < first + count; idx++, curr = curr->next) {
+            if (test(*curr->value)) {
+                matches++;
+            }
+        }
+        counts[range] = matches;
+    });
+
+    long total = 0;
+    for (long matches : counts) {
+        total += matches;
+    }
+    return total;
+}
@@ -0,0 +1,60 @@
+/// @file canvassearch.h
+/// @date October 2, 2023
+/// @brief The canvassearch file contains declarations for the ShapeFilter
+///     struct and the CanvasSearch class that finds or counts the shapes
+///     of a CanvasList matching a predicate. The list is split into
+///     ranges of nodes that are scanned on a ThreadPool.
+
+#pragma once
+
+#include <climits>
+#include <functional>
+#include <limits>
+#include <vector>
+#include "shape.h"
+#include "canvaslist.h"
+#include "threadpool.h"
+
+using namespace std;
+
+using ShapeTest = function<bool(const Shape &)>;
+
+// ShapeFilter struct matches shapes by type, anchor point and area
+// types has bit (1 << type) set for every accepted ShapeType
+// every range is inclusive and the defaults match every shape
+struct ShapeFilter
+{
+    unsigned types = ALL_TYPES;
+    int minX = INT_MIN;
+    int maxX = INT_MAX;
+    int minY = INT_MIN;
+    int maxY = INT_MAX;
+    double minArea = 0.0;
+    double maxArea = numeric_limits<double>::infinity();
+
+    static constexpr unsigned ALL_TYPES = 0xF;
+
+    static unsigned typeBit(ShapeType);
+    bool operator()(const Shape &) const;
+};
+
+// The CanvasSearch class runs predicate searches over a CanvasList.
+// Lists shorter than two ranges are scanned on the calling thread.
+// The list must not change while a search runs.
+class CanvasSearch
+{
+    private:
+        ThreadPool &pool;
+        int minRange;
+
+        void forEachRange(const CanvasList &, const function<void(int, ShapeNode *, int, int)> &) const;
+
+    public:
+        static constexpr int MIN_RANGE = 4096;
+
+        explicit CanvasSearch(ThreadPool &, int minRange = MIN_RANGE);
+
+        int findFirst(const CanvasList &, const ShapeTest &) const;
+        vector<int> findAll(const CanvasList &, const ShapeTest &) const;
+        long count(const CanvasList &, const ShapeTest &) const;
+};
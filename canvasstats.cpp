@@ -0,0 +1,440 @@
+// This file contains all the implementation functions used in canvasstats.h
+// Each kernel comes in scalar, SSE4.1 and AVX2 flavours like the ones in
+// bulktransform.cpp
+
+#include "canvasstats.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <numbers>
+#include "simdlevel.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define STATS_X86 1
+#endif
+using namespace std;
+
+// PairSums struct holds the sums one pass over two size columns gives
+struct PairSums
+{
+    double absA;
+    double absB;
+    double product;
+    double hypot;
+};
+
+// adds two ints, wrapping on overflow
+static inline int wrapAdd(int a, int b) {
+    return static_cast<int>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b));
+}
+
+// sums |a|, |b|, |a * b| and, if wanted, sqrt(a * a + b * b)
+static void sumPairsScalar(const int *a, const int *b, size_t count, bool hypot, PairSums &sums) {
+    for (size_t i = 0; i < count; i++) {
+        double u = fabs(static_cast<double>(a[i]));
+        double v = fabs(static_cast<double>(b[i]));
+        sums.absA += u;
+        sums.absB += v;
+        sums.product += u * v;
+        if (hypot) {
+            sums.hypot += sqrt(u * u + v * v);
+        }
+    }
+}
+
+// widens lo and hi to cover origin and origin + size for every row
+// size may be nullpointer for shapes that are a single point
+static void spanScalar(const int *origin, const int *size, size_t count, int &lo, int &hi) {
+    for (size_t i = 0; i < count; i++) {
+        int end = size == nullptr ? origin[i] : wrapAdd(origin[i], size[i]);
+        lo = min(lo, min(origin[i], end));
+        hi = max(hi, max(origin[i], end));
+    }
+}
+
+// wraps a widened value back into an int the way the vector lanes do
+static inline int wrapInt(long long value) {
+    return static_cast<int>(static_cast<uint32_t>(value));
+}
+
+// widens lo and hi to cover origin - |radius| and origin + |radius|
+// the radius is negated in long long so INT_MIN does not overflow
+static void centredScalar(const int *origin, const int *radius, size_t count, int &lo, int &hi) {
+    for (size_t i = 0; i < count; i++) {
+        long long r = radius[i] < 0 ? -static_cast<long long>(radius[i]) : radius[i];
+        lo = min(lo, wrapInt(origin[i] - r));
+        hi = max(hi, wrapInt(origin[i] + r));
+    }
+}
+
+// returns the histogram bucket of a non-negative area, read straight from
+// its exponent bits so the vector kernels can do the same
+static inline int bucketOf(double area) {
+    uint64_t bits;
+    memcpy(&bits, &area, sizeof(bits));
+    long long bucket = static_cast<long long>(bits >> 52) - 1022;
+    return static_cast<int>(clamp(bucket, 0LL, TypeSummary::AREA_BUCKETS - 1LL));
+}
+
+// counts scale * |a| * |b| for every row into buckets
+// the multiplications run in the same order as the shapes' getArea
+static void bucketPairsScalar(const int *a, const int *b, size_t count, double scale, long *buckets) {
+    for (size_t i = 0; i < count; i++) {
+        double u = fabs(static_cast<double>(a[i]));
+        double v = fabs(static_cast<double>(b[i]));
+        buckets[bucketOf(scale * u * v)]++;
+    }
+}
+
+#ifdef STATS_X86
+
+// sums two rows at a time in double lanes
+__attribute__((target("sse4.1")))
+static void sumPairsSSE41(const int *a, const int *b, size_t count, bool hypot, PairSums &sums) {
+    const __m128d signless = _mm_castsi128_pd(_mm_set1_epi64x(INT64_MAX));
+    __m128d absA = _mm_setzero_pd();
+    __m128d absB = _mm_setzero_pd();
+    __m128d product = _mm_setzero_pd();
+    __m128d hyp = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d u = _mm_and_pd(_mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(a + i))), signless);
+        __m128d v = _mm_and_pd(_mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(b + i))), signless);
+        absA = _mm_add_pd(absA, u);
+        absB = _mm_add_pd(absB, v);
+        product = _mm_add_pd(product, _mm_mul_pd(u, v));
+        if (hypot) {
+            hyp = _mm_add_pd(hyp, _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(u, u), _mm_mul_pd(v, v))));
+        }
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, absA);
+    sums.absA += lanes[0] + lanes[1];
+    _mm_storeu_pd(lanes, absB);
+    sums.absB += lanes[0] + lanes[1];
+    _mm_storeu_pd(lanes, product);
+    sums.product += lanes[0] + lanes[1];
+    _mm_storeu_pd(lanes, hyp);
+    sums.hypot += lanes[0] + lanes[1];
+    sumPairsScalar(a + i, b + i, count - i, hypot, sums);
+}
+
+// checks four rows at a time
+__attribute__((target("sse4.1")))
+static void spanSSE41(const int *origin, const int *size, size_t count, int &lo, int &hi) {
+    __m128i low = _mm_set1_epi32(lo);
+    __m128i high = _mm_set1_epi32(hi);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i start = _mm_loadu_si128(reinterpret_cast<const __m128i *>(origin + i));
+        __m128i end = start;
+        if (size != nullptr) {
+            end = _mm_add_epi32(start, _mm_loadu_si128(reinterpret_cast<const __m128i *>(size + i)));
+        }
+        low = _mm_min_epi32(low, _mm_min_epi32(start, end));
+        high = _mm_max_epi32(high, _mm_max_epi32(start, end));
+    }
+    int lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), low);
+    lo = min(min(lanes[0], lanes[1]), min(lanes[2], lanes[3]));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), high);
+    hi = max(max(lanes[0], lanes[1]), max(lanes[2], lanes[3]));
+    spanScalar(origin + i, size == nullptr ? nullptr : size + i, count - i, lo, hi);
+}
+
+// checks four rows at a time
+__attribute__((target("sse4.1")))
+static void centredSSE41(const int *origin, const int *radius, size_t count, int &lo, int &hi) {
+    __m128i low = _mm_set1_epi32(lo);
+    __m128i high = _mm_set1_epi32(hi);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i centre = _mm_loadu_si128(reinterpret_cast<const __m128i *>(origin + i));
+        __m128i r = _mm_abs_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(radius + i)));
+        low = _mm_min_epi32(low, _mm_sub_epi32(centre, r));
+        high = _mm_max_epi32(high, _mm_add_epi32(centre, r));
+    }
+    int lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), low);
+    lo = min(min(lanes[0], lanes[1]), min(lanes[2], lanes[3]));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), high);
+    hi = max(max(lanes[0], lanes[1]), max(lanes[2], lanes[3]));
+    centredScalar(origin + i, radius + i, count - i, lo, hi);
+}
+
+// finds the buckets of two rows at a time
+// the exponent minus its bias fits the low half of each lane, and clamping
+// both halves as int lanes leaves the whole lane between 0 and the last bucket
+__attribute__((target("sse4.1")))
+static void bucketPairsSSE41(const int *a, const int *b, size_t count, double scale, long *buckets) {
+    const __m128d signless = _mm_castsi128_pd(_mm_set1_epi64x(INT64_MAX));
+    const __m128d factor = _mm_set1_pd(scale);
+    const __m128i bias = _mm_set1_epi64x(1022);
+    const __m128i last = _mm_set1_epi32(TypeSummary::AREA_BUCKETS - 1);
+    long long lanes[2];
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d u = _mm_and_pd(_mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(a + i))), signless);
+        __m128d v = _mm_and_pd(_mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(b + i))), signless);
+        __m128d area = _mm_mul_pd(_mm_mul_pd(factor, u), v);
+        __m128i bucket = _mm_sub_epi64(_mm_srli_epi64(_mm_castpd_si128(area), 52), bias);
+        bucket = _mm_min_epi32(_mm_max_epi32(bucket, _mm_setzero_si128()), last);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), bucket);
+        buckets[lanes[0]]++;
+        buckets[lanes[1]]++;
+    }
+    bucketPairsScalar(a + i, b + i, count - i, scale, buckets);
+}
+
+// sums four rows at a time in double lanes
+__attribute__((target("avx2")))
+static void sumPairsAVX2(const int *a, const int *b, size_t count, bool hypot, PairSums &sums) {
+    const __m256d signless = _mm256_castsi256_pd(_mm256_set1_epi64x(INT64_MAX));
+    __m256d absA = _mm256_setzero_pd();
+    __m256d absB = _mm256_setzero_pd();
+    __m256d product = _mm256_setzero_pd();
+    __m256d hyp = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d u = _mm256_and_pd(_mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i))), signless);
+        __m256d v = _mm256_and_pd(_mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i))), signless);
+        absA = _mm256_add_pd(absA, u);
+        absB = _mm256_add_pd(absB, v);
+        product = _mm256_add_pd(product, _mm256_mul_pd(u, v));
+        if (hypot) {
+            hyp = _mm256_add_pd(hyp, _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(u, u), _mm256_mul_pd(v, v))));
+        }
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, absA);
+    sums.absA += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    _mm256_storeu_pd(lanes, absB);
+    sums.absB += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    _mm256_storeu_pd(lanes, product);
+    sums.product += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    _mm256_storeu_pd(lanes, hyp);
+    sums.hypot += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    sumPairsScalar(a + i, b + i, count - i, hypot, sums);
+}
+
+// finds the buckets of four rows at a time, clamped like the SSE4.1 kernel
+__attribute__((target("avx2")))
+static void bucketPairsAVX2(const int *a, const int *b, size_t count, double scale, long *buckets) {
+    const __m256d signless = _mm256_castsi256_pd(_mm256_set1_epi64x(INT64_MAX));
+    const __m256d factor = _mm256_set1_pd(scale);
+    const __m256i bias = _mm256_set1_epi64x(1022);
+    const __m256i last = _mm256_set1_epi32(TypeSummary::AREA_BUCKETS - 1);
+    long long lanes[4];
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d u = _mm256_and_pd(_mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i))), signless);
+        __m256d v = _mm256_and_pd(_mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i))), signless);
+        __m256d area = _mm256_mul_pd(_mm256_mul_pd(factor, u), v);
+        __m256i bucket = _mm256_sub_epi64(_mm256_srli_epi64(_mm256_castpd_si256(area), 52), bias);
+        bucket = _mm256_min_epi32(_mm256_max_epi32(bucket, _mm256_setzero_si256()), last);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), bucket);
+        buckets[lanes[0]]++;
+        buckets[lanes[1]]++;
+        buckets[lanes[2]]++;
+        buckets[lanes[3]]++;
+    }
+    bucketPairsScalar(a + i, b + i, count - i, scale, buckets);
+}
+
+// reduces eight int lanes to their smallest and largest
+__attribute__((target("avx2")))
+static void reduceAVX2(__m256i low, __m256i high, int &lo, int &hi) {
+    int lanes[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), low);
+    lo = *min_element(lanes, lanes + 8);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), high);
+    hi = *max_element(lanes, lanes + 8);
+}
+
+// checks eight rows at a time
+__attribute__((target("avx2")))
+static void spanAVX2(const int *origin, const int *size, size_t count, int &lo, int &hi) {
+    __m256i low = _mm256_set1_epi32(lo);
+    __m256i high = _mm256_set1_epi32(hi);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i start = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(origin + i));
+        __m256i end = start;
+        if (size != nullptr) {
+            end = _mm256_add_epi32(start, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(size + i)));
+        }
+        low = _mm256_min_epi32(low, _mm256_min_epi32(start, end));
+        high = _mm256_max_epi32(high, _mm256_max_epi32(start, end));
+    }
+    reduceAVX2(low, high, lo, hi);
+    spanScalar(origin + i, size == nullptr ? nullptr : size + i, count - i, lo, hi);
+}
+
+// checks eight rows at a time
+__attribute__((target("avx2")))
+static void centredAVX2(const int *origin, const int *radius, size_t count, int &lo, int &hi) {
+    __m256i low = _mm256_set1_epi32(lo);
+    __m256i high = _mm256_set1_epi32(hi);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i centre = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(origin + i));
+        __m256i r = _mm256_abs_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(radius + i)));
+        low = _mm256_min_epi32(low, _mm256_sub_epi32(centre, r));
+        high = _mm256_max_epi32(high, _mm256_add_epi32(centre, r));
+    }
+    reduceAVX2(low, high, lo, hi);
+    centredScalar(origin + i, radius + i, count - i, lo, hi);
+}
+
+#endif
+
+// sums a pair of size columns using the active kernel
+static void sumPairs(const vector<int> &a, const vector<int> &b, bool hypot, PairSums &sums) {
+#ifdef STATS_X86
+    switch (SimdLevel::active()) {
+        case SIMD_AVX2: sumPairsAVX2(a.data(), b.data(), a.size(), hypot, sums); return;
+        case SIMD_SSE41: sumPairsSSE41(a.data(), b.data(), a.size(), hypot, sums); return;
+        default: break;
+    }
+#endif
+    sumPairsScalar(a.data(), b.data(), a.size(), hypot, sums);
+}
+
+// buckets the areas scale * |a| * |b| of a pair of size columns using the
+// active kernel
+static void bucketPairs(const vector<int> &a, const vector<int> &b, double scale, long *buckets) {
+#ifdef STATS_X86
+    switch (SimdLevel::active()) {
+        case SIMD_AVX2: bucketPairsAVX2(a.data(), b.data(), a.size(), scale, buckets); return;
+        case SIMD_SSE41: bucketPairsSSE41(a.data(), b.data(), a.size(), scale, buckets); return;
+        default: break;
+    }
+#endif
+    bucketPairsScalar(a.data(), b.data(), a.size(), scale, buckets);
+}
+
+// widens lo and hi over a column of origins and optional sizes
+static void span(const vector<int> &origin, const vector<int> *size, int &lo, int &hi) {
+    const int *sizes = size == nullptr ? nullptr : size->data();
+#ifdef STATS_X86
+    switch (SimdLevel::active()) {
+        case SIMD_AVX2: spanAVX2(origin.data(), sizes, origin.size(), lo, hi); return;
+        case SIMD_SSE41: spanSSE41(origin.data(), sizes, origin.size(), lo, hi); return;
+        default: break;
+    }
+#endif
+    spanScalar(origin.data(), sizes, origin.size(), lo, hi);
+}
+
+// widens lo and hi over a column of centres and radii
+static void centred(const vector<int> &origin, const vector<int> &radius, int &lo, int &hi) {
+#ifdef STATS_X86
+    switch (SimdLevel::active()) {
+        case SIMD_AVX2: centredAVX2(origin.data(), radius.data(), origin.size(), lo, hi); return;
+        case SIMD_SSE41: centredSSE41(origin.data(), radius.data(), origin.size(), lo, hi); return;
+        default: break;
+    }
+#endif
+    centredScalar(origin.data(), radius.data(), origin.size(), lo, hi);
+}
+
+// fills in the canvas totals from the per type ones
+// bounds must already hold the union, or INT_MAX / INT_MIN if empty
+static void finish(CanvasSummary &summary) {
+    for (const TypeSummary &type : summary.types) {
+        summary.count += type.count;
+        summary.area += type.area;
+        summary.perimeter += type.perimeter;
+    }
+    if (summary.count == 0) {
+        summary.bounds = Bounds{0, 0, 0, 0};
+    }
+}
+
+// returns an empty summary whose bounds any shape will replace
+static CanvasSummary emptySummary() {
+    CanvasSummary summary{};
+    summary.bounds = Bounds{INT_MAX, INT_MAX, INT_MIN, INT_MIN};
+    return summary;
+}
+
+// returns the TypeSummary::areaBuckets index area is counted in
+int CanvasStats::areaBucket(double area) {
+    return bucketOf(fabs(area));
+}
+
+// totals every shape in list through its own getArea, getPerimeter and getBounds
+CanvasSummary CanvasStats::summarize(const CanvasList &list) {
+    CanvasSummary summary = emptySummary();
+    for (ShapeNode *curr = list.front(); curr != nullptr; curr = curr->next) {
+        const Shape *shape = curr->value;
+        TypeSummary &type = summary.types[shape->getType()];
+        double area = shape->getArea();
+        type.count++;
+        type.area += area;
+        type.areaBuckets[bucketOf(area)]++;
+        type.perimeter += shape->getPerimeter();
+
+        Bounds b = shape->getBounds();
+        summary.bounds.minX = min(summary.bounds.minX, b.minX);
+        summary.bounds.minY = min(summary.bounds.minY, b.minY);
+        summary.bounds.maxX = max(summary.bounds.maxX, b.maxX);
+        summary.bounds.maxY = max(summary.bounds.maxY, b.maxY);
+    }
+    finish(summary);
+    return summary;
+}
+
+// totals every shape in canvas with one pass of bulk kernels per column
+CanvasSummary CanvasStats::summarize(const ColumnCanvas &canvas) {
+    CanvasSummary summary = emptySummary();
+    Bounds &bounds = summary.bounds;
+
+    const ColumnGroup &basics = canvas.group(SHAPE_BASIC);
+    summary.types[SHAPE_BASIC].count = basics.size();
+    summary.types[SHAPE_BASIC].areaBuckets[0] = basics.size();
+    span(basics.x, nullptr, bounds.minX, bounds.maxX);
+    span(basics.y, nullptr, bounds.minY, bounds.maxY);
+
+    // circles pair the radius with itself, so product is the radius squared
+    const ColumnGroup &circles = canvas.group(SHAPE_CIRCLE);
+    PairSums circleSums{};
+    sumPairs(circles.a, circles.a, false, circleSums);
+    TypeSummary circleType{};
+    circleType.count = circles.size();
+    circleType.area = numbers::pi * circleSums.product;
+    circleType.perimeter = 2 * numbers::pi * circleSums.absA;
+    bucketPairs(circles.a, circles.a, numbers::pi, circleType.areaBuckets);
+    summary.types[SHAPE_CIRCLE] = circleType;
+    centred(circles.x, circles.a, bounds.minX, bounds.maxX);
+    centred(circles.y, circles.a, bounds.minY, bounds.maxY);
+
+    const ColumnGroup &rects = canvas.group(SHAPE_RECT);
+    PairSums rectSums{};
+    sumPairs(rects.a, rects.b, false, rectSums);
+    TypeSummary rectType{};
+    rectType.count = rects.size();
+    rectType.area = rectSums.product;
+    rectType.perimeter = 2 * (rectSums.absA + rectSums.absB);
+    bucketPairs(rects.a, rects.b, 1.0, rectType.areaBuckets);
+    summary.types[SHAPE_RECT] = rectType;
+    span(rects.x, &rects.a, bounds.minX, bounds.maxX);
+    span(rects.y, &rects.b, bounds.minY, bounds.maxY);
+
+    const ColumnGroup &triangles = canvas.group(SHAPE_RIGHT_TRIANGLE);
+    PairSums triangleSums{};
+    sumPairs(triangles.a, triangles.b, true, triangleSums);
+    TypeSummary triangleType{};
+    triangleType.count = triangles.size();
+    triangleType.area = triangleSums.product / 2;
+    triangleType.perimeter = triangleSums.absA + triangleSums.absB + triangleSums.hypot;
+    bucketPairs(triangles.a, triangles.b, 0.5, triangleType.areaBuckets);
+    summary.types[SHAPE_RIGHT_TRIANGLE] = triangleType;
+    span(triangles.x, &triangles.a, bounds.minX, bounds.maxX);
+    span(triangles.y, &triangles.b, bounds.minY, bounds.maxY);
+
+    finish(summary);
+    return summary;
+}
@@ -0,0 +1,51 @@
+/// @file canvasstats.h
+/// @date October 2, 2023
+/// @brief The canvasstats file contains declarations for the CanvasStats
+///     class that totals area and perimeter per shape type, buckets the
+///     areas of each type into a histogram and finds the bounding box of
+///     a whole canvas. The ColumnCanvas version runs AVX2, SSE4.1 or
+///     scalar kernels over the columns, chosen at run time through
+///     SimdLevel.
+
+#pragma once
+
+#include "shape.h"
+#include "canvaslist.h"
+#include "columncanvas.h"
+
+// TypeSummary struct totals every shape of one type
+// areaBuckets is a histogram of the shapes' areas: bucket 0 counts areas
+// below 1, bucket k counts areas from 2^(k-1) up to 2^k and the last
+// bucket also takes everything bigger
+struct TypeSummary
+{
+    static constexpr int AREA_BUCKETS = 32;
+
+    long count;
+    double area;
+    double perimeter;
+    long areaBuckets[AREA_BUCKETS];
+};
+
+// CanvasSummary struct totals a whole canvas
+// bounds is the union of every getBounds() and is only set if count > 0
+struct CanvasSummary
+{
+    TypeSummary types[4];
+    long count;
+    double area;
+    double perimeter;
+    Bounds bounds;
+};
+
+// The CanvasStats class computes the same summary for a CanvasList,
+// through the shapes' own functions, or for a ColumnCanvas, with bulk
+// kernels. Vector kernels add in a different order, so float totals can
+// differ from the scalar ones in the last few bits.
+class CanvasStats
+{
+    public:
+        static CanvasSummary summarize(const CanvasList &);
+        static CanvasSummary summarize(const ColumnCanvas &);
+        static int areaBucket(double area);
+};
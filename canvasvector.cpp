@@ -0,0 +1,174 @@
+// This file contains all the implementation functions used in canvasvector.h
+// Every operation mirrors the CanvasList function of the same name
+
+#include "canvasvector.h"
+#include <iostream>
+using namespace std;
+
+// Default constructor : initializes empty canvasVector
+CanvasVector::CanvasVector() {}
+
+// Copy Constructor : creates new canvasVector which is copied from another canvasVector
+CanvasVector::CanvasVector(const CanvasVector &copyConst) {
+    shapes.reserve(copyConst.shapes.size());
+    for (Shape *shape : copyConst.shapes) {
+        shapes.push_back(shape->copy());
+    }
+}
+
+// Conversion Constructor : creates new canvasVector which is copied from a canvasList
+CanvasVector::CanvasVector(const CanvasList &list) {
+    shapes.reserve(list.size());
+    for (ShapeNode *curr = list.front(); curr != nullptr; curr = curr->next) {
+        shapes.push_back(curr->value->copy());
+    }
+}
+
+// Assignment operator : assigns contents of different canvasVector to this canvasVector
+CanvasVector& CanvasVector::operator=(const CanvasVector &newCopyConst) {
+    if (this == &newCopyConst) {
+        return *this;
+    }
+    clear();
+
+    shapes.reserve(newCopyConst.shapes.size());
+    for (Shape *shape : newCopyConst.shapes) {
+        shapes.push_back(shape->copy());
+    }
+    return *this;
+}
+
+// Destructor that deallocates memory for all shapes in the array
+CanvasVector::~CanvasVector() {
+    clear();
+}
+
+// clears the array and deallocates memory for all shapes in it
+void CanvasVector::clear() {
+    for (Shape *shape : shapes) {
+        delete shape;
+    }
+    shapes.clear();
+}
+
+// reserves room for the given number of shapes so pushes do not reallocate
+void CanvasVector::reserve(int capacity) {
+    if (capacity > 0) {
+        shapes.reserve(capacity);
+    }
+}
+
+// inserts shape after given index
+// does nothing if the index is out of range
+void CanvasVector::insertAfter(int idx, Shape *shape) {
+    if (idx < 0 || idx >= size()) {
+        return;
+    }
+    shapes.insert(shapes.begin() + idx + 1, shape);
+}
+
+// pushes shape to front of array
+// shifts every other shape up by one
+void CanvasVector::push_front(Shape *shape) {
+    shapes.insert(shapes.begin(), shape);
+}
+
+// pushes shape to back of array
+void CanvasVector::push_back(Shape *shape) {
+    shapes.push_back(shape);
+}
+
+// removes shape at given index
+// does nothing if index out of range
+void CanvasVector::removeAt(int idx) {
+    if (idx < 0 || idx >= size()) {
+        return;
+    }
+    delete shapes[idx];
+    shapes.erase(shapes.begin() + idx);
+}
+
+// removes every other shape in array
+// first removal is index 1
+void CanvasVector::removeEveryOther() {
+    int kept = 0;
+    for (int idx = 0; idx < size(); idx++) {
+        if (idx % 2 != 0) {
+            delete shapes[idx];
+        }
+        else {
+            // compacts the kept shapes towards the front in one pass
+            shapes[kept] = shapes[idx];
+            kept++;
+        }
+    }
+    shapes.resize(kept);
+}
+
+// pops and returns the front of array shape
+// returns nullpointer if array is empty
+Shape* CanvasVector::pop_front() {
+    if (isempty()) {
+        return nullptr;
+    }
+    Shape *shape = shapes.front();
+    shapes.erase(shapes.begin());
+    return shape;
+}
+
+// pops and returns back of array shape
+// return nullpointer if array is empty
+Shape* CanvasVector::pop_back() {
+    if (isempty()) {
+        return nullptr;
+    }
+    Shape *shape = shapes.back();
+    shapes.pop_back();
+    return shape;
+}
+
+// checks if array is empty
+bool CanvasVector::isempty() const {
+    return shapes.empty();
+}
+
+// returns size of array
+int CanvasVector::size() const {
+    return static_cast<int>(shapes.size());
+}
+
+// finds index of shape with given points
+// returns -1 if shape not found
+// return index if shape is found
+int CanvasVector::find(int x, int y) const {
+    for (int idx = 0; idx < size(); idx++) {
+        if (shapes[idx]->getX() == x && shapes[idx]->getY() == y) {
+            return idx;
+        }
+    }
+    return -1;
+}
+
+// returns pointer to shape at given index
+// returns nullpointer if index is out of range
+Shape* CanvasVector::shapeAt(int idx) const {
+    if (idx < 0 || idx >= size()) {
+        return nullptr;
+    }
+    return shapes[idx];
+}
+
+// draws all shapes in array
+void CanvasVector::draw() const {
+    for (Shape *shape : shapes) {
+        cout << shape->printShape() << endl;
+    }
+}
+
+// prints all addresses and info of all shapes in array
+void CanvasVector::printAddresses() const {
+    for (Shape *const &shape : shapes) {
+        // prints out the array slot address and the slot's value(shape) address
+        cout << "Slot Address: " << &shape << "    Shape Address: " << shape << endl;
+    }
+}
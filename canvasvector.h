@@ -0,0 +1,51 @@
+/// @file canvasvector.h
+/// @date October 2, 2023
+/// @brief The canvasvector file contains declarations for the CanvasVector
+///     class, a sibling of CanvasList with the same interface that keeps
+///     its shapes in one contiguous array instead of a chain of nodes.
+///     Indexed access is constant time and traversals walk memory in
+///     order, at the cost of linear-time insertion away from the back.
+
+#pragma once
+
+#include <vector>
+#include "shape.h"
+#include "canvaslist.h"
+
+using namespace std;
+
+// The CanvasVector class stores the same shapes a CanvasList does, in the
+// same order and with the same ownership rules, in a contiguous array.
+class CanvasVector
+{
+    private:
+        vector<Shape *> shapes;
+
+    public:
+        CanvasVector();
+        CanvasVector(const CanvasVector &);
+        explicit CanvasVector(const CanvasList &);
+        CanvasVector& operator=(const CanvasVector &);
+
+        virtual ~CanvasVector();
+        void clear();
+        void reserve(int);
+
+        void insertAfter(int, Shape *);
+        void push_front(Shape *);
+        void push_back(Shape *);
+
+        void removeAt(int);
+        void removeEveryOther();
+        Shape* pop_front();
+        Shape* pop_back();
+
+        bool isempty() const;
+        int size() const;
+
+        int find(int x, int y) const;
+        Shape* shapeAt(int) const;
+
+        void draw() const;
+        void printAddresses() const;
+};
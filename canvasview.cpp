@@ -0,0 +1,140 @@
+// This file contains all the implementation functions used in canvasview.h
+// It maps a canvas file and reads its records in place
+
+#include "canvasview.h"
+#include "blockwriter.h"
+#include <climits>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using namespace std;
+
+// Default constructor : initializes a view with no file
+CanvasView::CanvasView() : mapping(nullptr), mappedBytes(0), count(0) {}
+
+// Destructor that unmaps the file
+CanvasView::~CanvasView() {
+    close();
+}
+
+// maps the canvas file at path, replacing any file already open
+// returns false and leaves the view closed if the file is missing,
+// has a bad header or is shorter than its header says
+bool CanvasView::open(const string &path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < CanvasFile::HEADER_SIZE) {
+        ::close(fd);
+        return false;
+    }
+
+    size_t bytes = static_cast<size_t>(info.st_size);
+    void *mapped = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping keeps the file alive so the descriptor is not needed
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+
+    uint64_t records;
+    const char *data = static_cast<const char *>(mapped);
+    if (!CanvasFile::readHeader(data, records) || records > INT_MAX ||
+        bytes < CanvasFile::HEADER_SIZE + records * CanvasFile::RECORD_SIZE) {
+        munmap(mapped, bytes);
+        return false;
+    }
+
+    mapping = data;
+    mappedBytes = bytes;
+    count = static_cast<int>(records);
+    return true;
+}
+
+// unmaps the file
+void CanvasView::close() {
+    if (mapping != nullptr) {
+        munmap(const_cast<char *>(mapping), mappedBytes);
+    }
+    mapping = nullptr;
+    mappedBytes = 0;
+    count = 0;
+}
+
+// checks if a file is mapped
+bool CanvasView::isopen() const {
+    return mapping != nullptr;
+}
+
+// checks if the view has no shapes
+bool CanvasView::isempty() const {
+    return count == 0;
+}
+
+// returns the number of shapes in the file
+int CanvasView::size() const {
+    return count;
+}
+
+// returns the bytes of the record at index, which must be in range
+const char* CanvasView::record(int idx) const {
+    return mapping + CanvasFile::HEADER_SIZE + static_cast<size_t>(idx) * CanvasFile::RECORD_SIZE;
+}
+
+// finds index of shape with given points
+// returns -1 if shape not found
+int CanvasView::find(int x, int y) const {
+    for (int idx = 0; idx < count; idx++) {
+        const char *bytes = record(idx);
+        if (static_cast<int>(CanvasFile::readInt(bytes + 4)) == x && static_cast<int>(CanvasFile::readInt(bytes + 8)) == y) {
+            return idx;
+        }
+    }
+    return -1;
+}
+
+// fills out with the shape at given index
+// returns false if the index is out of range or the record is corrupt
+bool CanvasView::shapeAt(int idx, ShapeRecord &out) const {
+    if (idx < 0 || idx >= count) {
+        return false;
+    }
+    return CanvasFile::readRecord(record(idx), out);
+}
+
+// draws all shapes in the file to the console
+void CanvasView::draw() const {
+    draw(cout);
+    cout.flush();
+}
+
+// draws all shapes in the file to out, the same lines CanvasList::draw writes
+// corrupt records are skipped
+void CanvasView::draw(ostream &out) const {
+    BlockWriter writer(out);
+    ShapeRecord shape;
+    for (int idx = 0; idx < count; idx++) {
+        if (CanvasFile::readRecord(record(idx), shape)) {
+            shape.printShape(writer.text());
+            writer.endLine();
+        }
+    }
+}
+
+// draws all shapes in the file to an open file descriptor
+void CanvasView::draw(int fd) const {
+    BlockWriter writer(fd);
+    ShapeRecord shape;
+    for (int idx = 0; idx < count; idx++) {
+        if (CanvasFile::readRecord(record(idx), shape)) {
+            shape.printShape(writer.text());
+            writer.endLine();
+        }
+    }
+}
@@ -0,0 +1,47 @@
+/// @file canvasview.h
+/// @date October 2, 2023
+/// @brief The canvasview file contains declarations for the CanvasView
+///     class, a read-only view of a canvas file. The file is memory
+///     mapped and every query reads the mapped records directly, so
+///     opening is instant and pages are only read when first touched.
+
+#pragma once
+
+#include <ostream>
+#include <string>
+#include "canvasfile.h"
+
+using namespace std;
+
+// The CanvasView class answers the read-only CanvasList queries over a
+// canvas file written by CanvasList::save. No Shape objects are created;
+// shapeAt fills in a ShapeRecord instead.
+class CanvasView
+{
+    private:
+        const char *mapping;
+        size_t mappedBytes;
+        int count;
+
+        const char* record(int idx) const;
+
+    public:
+        CanvasView();
+        CanvasView(const CanvasView &) = delete;
+        CanvasView& operator=(const CanvasView &) = delete;
+        ~CanvasView();
+
+        bool open(const string &path);
+        void close();
+        bool isopen() const;
+
+        bool isempty() const;
+        int size() const;
+
+        int find(int x, int y) const;
+        bool shapeAt(int idx, ShapeRecord &out) const;
+
+        void draw() const;
+        void draw(ostream &) const;
+        void draw(int fd) const;
+};
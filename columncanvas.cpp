@@ -0,0 +1,153 @@
+// This file contains all the implementation functions used in columncanvas.h
+// Shapes enter and leave as ShapeRecords, which already name the a and b
+// fields each type uses
+
+#include "columncanvas.h"
+#include <algorithm>
+#include <climits>
+#include "blockwriter.h"
+using namespace std;
+
+// returns the number of shapes in the group
+int ColumnGroup::size() const {
+    return static_cast<int>(x.size());
+}
+
+// Default constructor : initializes empty columnCanvas
+ColumnCanvas::ColumnCanvas() {}
+
+// Conversion Constructor : creates new columnCanvas holding a canvasList's shapes
+ColumnCanvas::ColumnCanvas(const CanvasList &list) {
+    order.reserve(list.size());
+    for (ShapeNode *curr = list.front(); curr != nullptr; curr = curr->next) {
+        push_back(*curr->value);
+    }
+}
+
+// removes every shape
+void ColumnCanvas::clear() {
+    for (ColumnGroup &columns : groups) {
+        columns = ColumnGroup();
+    }
+    order.clear();
+}
+
+// reserves room in the order array for the given number of shapes
+// group columns grow as shapes of each type arrive
+void ColumnCanvas::reserve(int capacity) {
+    if (capacity > 0) {
+        order.reserve(capacity);
+    }
+}
+
+// appends a copy of shape's fields to the back of the canvas
+// returns false if the shape's type is unknown
+bool ColumnCanvas::push_back(const Shape &shape) {
+    return push_back(ShapeRecord::fromShape(shape));
+}
+
+// appends the shape described by record to the back of the canvas
+// returns false and leaves the canvas unchanged if the type is unknown
+bool ColumnCanvas::push_back(const ShapeRecord &record) {
+    if (record.type < SHAPE_BASIC || record.type >= GROUP_COUNT) {
+        return false;
+    }
+    ColumnGroup &columns = groups[record.type];
+    order.push_back(ShapeSlot{record.type, columns.size()});
+    columns.x.push_back(record.x);
+    columns.y.push_back(record.y);
+    if (record.type != SHAPE_BASIC) {
+        columns.a.push_back(record.a);
+    }
+    if (record.type == SHAPE_RECT || record.type == SHAPE_RIGHT_TRIANGLE) {
+        columns.b.push_back(record.b);
+    }
+    columns.position.push_back(size() - 1);
+    return true;
+}
+
+// returns true if canvas is empty and false if it is not
+bool ColumnCanvas::isempty() const {
+    return order.empty();
+}
+
+// returns number of shapes in canvas
+int ColumnCanvas::size() const {
+    return static_cast<int>(order.size());
+}
+
+// returns number of shapes of the given type
+int ColumnCanvas::count(ShapeType type) const {
+    return groups[type].size();
+}
+
+// returns the columns holding shapes of the given type
+ColumnGroup& ColumnCanvas::group(ShapeType type) {
+    return groups[type];
+}
+
+// returns the columns holding shapes of the given type
+const ColumnGroup& ColumnCanvas::group(ShapeType type) const {
+    return groups[type];
+}
+
+// returns where the shape at given index is stored
+// index must be in range
+ShapeSlot ColumnCanvas::slotAt(int idx) const {
+    return order[idx];
+}
+
+// fills record with the shape at given index
+// returns false if index is out of range
+bool ColumnCanvas::recordAt(int idx, ShapeRecord &record) const {
+    if (idx < 0 || idx >= size()) {
+        return false;
+    }
+    ShapeSlot slot = order[idx];
+    const ColumnGroup &columns = groups[slot.type];
+    record.type = slot.type;
+    record.x = columns.x[slot.row];
+    record.y = columns.y[slot.row];
+    record.a = columns.a.empty() ? 0 : columns.a[slot.row];
+    record.b = columns.b.empty() ? 0 : columns.b[slot.row];
+    return true;
+}
+
+// finds index of shape with given points
+// returns -1 if shape not found
+// return index if shape is found
+int ColumnCanvas::find(int x, int y) const {
+    int best = INT_MAX;
+    for (const ColumnGroup &columns : groups) {
+        // rows are in canvas order, so the first hit is the group's earliest
+        const int *xs = columns.x.data();
+        const int *ys = columns.y.data();
+        for (int row = 0; row < columns.size(); row++) {
+            if (xs[row] == x && ys[row] == y) {
+                best = min(best, columns.position[row]);
+                break;
+            }
+        }
+    }
+    return best == INT_MAX ? -1 : best;
+}
+
+// pushes heap copies of every shape onto the back of list, in order
+void ColumnCanvas::appendTo(CanvasList &list) const {
+    ShapeRecord record;
+    for (int idx = 0; idx < size(); idx++) {
+        recordAt(idx, record);
+        list.push_back(record.toShape());
+    }
+}
+
+// draws all shapes in canvas order to out, one printShape line per shape
+void ColumnCanvas::draw(ostream &out) const {
+    BlockWriter writer(out);
+    ShapeRecord record;
+    for (int idx = 0; idx < size(); idx++) {
+        recordAt(idx, record);
+        record.printShape(writer.text());
+        writer.endLine();
+    }
+}
@@ -0,0 +1,75 @@
+/// @file columncanvas.h
+/// @date October 2, 2023
+/// @brief The columncanvas file contains declarations for the ColumnCanvas
+///     class, a structure of arrays layout for a canvas. Shapes are split
+///     into one group per ShapeType and each field of a group is its own
+///     contiguous int array, so bulk geometry can run over plain columns.
+///     An order array remembers where every shape sat in the CanvasList.
+
+#pragma once
+
+#include <ostream>
+#include <vector>
+#include "shape.h"
+#include "canvaslist.h"
+#include "canvasfile.h"
+
+using namespace std;
+
+// ColumnGroup struct holds every shape of one type, one array per field
+// a and b hold radius (Circle), width and height (Rect) or base and
+// height (RightTriangle), as in ShapeRecord, and are left empty when the
+// type has no such field. position is the shape's index in the canvas.
+struct ColumnGroup
+{
+    vector<int> x;
+    vector<int> y;
+    vector<int> a;
+    vector<int> b;
+    vector<int> position;
+
+    int size() const;
+};
+
+// ShapeSlot struct says which group and which row holds a shape
+struct ShapeSlot
+{
+    ShapeType type;
+    int row;
+};
+
+// The ColumnCanvas class keeps the shapes of a canvas as columns.
+// Shapes can be appended and read back in canvas order; within a group
+// rows are in canvas order too, so a scan of one group finds the
+// earliest match first.
+class ColumnCanvas
+{
+    private:
+        static constexpr int GROUP_COUNT = 4;
+
+        ColumnGroup groups[GROUP_COUNT];
+        vector<ShapeSlot> order;
+
+    public:
+        ColumnCanvas();
+        explicit ColumnCanvas(const CanvasList &);
+
+        void clear();
+        void reserve(int);
+        bool push_back(const Shape &);
+        bool push_back(const ShapeRecord &);
+
+        bool isempty() const;
+        int size() const;
+        int count(ShapeType) const;
+
+        ColumnGroup& group(ShapeType);
+        const ColumnGroup& group(ShapeType) const;
+        ShapeSlot slotAt(int) const;
+        bool recordAt(int, ShapeRecord &) const;
+
+        int find(int x, int y) const;
+        void appendTo(CanvasList &) const;
+
+        void draw(ostream &) const;
+};
@@ -0,0 +1,173 @@
+// This file contains all the implementation functions used in concurrentcanvas.h
+// Writers publish a node with a release store once it is complete and
+// readers load links with acquire, so a reader never sees half a node
+
+#include "concurrentcanvas.h"
+#include <iostream>
+#include "blockwriter.h"
+using namespace std;
+
+// Default constructor : initializes empty concurrentCanvas
+ConcurrentCanvas::ConcurrentCanvas() : head(nullptr), tail(nullptr), count(0) {}
+
+// Destructor that deallocates memory for all nodes and shapes
+// no reader may still be using the canvas
+ConcurrentCanvas::~ConcurrentCanvas() {
+    ConcurrentNode *curr = head.load(memory_order_relaxed);
+    while (curr != nullptr) {
+        ConcurrentNode *next = curr->next.load(memory_order_relaxed);
+        destroyNode(curr);
+        curr = next;
+    }
+}
+
+// deletes a retired node and its shape
+void ConcurrentCanvas::destroyNode(void *object) {
+    ConcurrentNode *node = static_cast<ConcurrentNode *>(object);
+    delete node->value;
+    delete node;
+}
+
+// returns the node at given index, for writers holding writeLock
+// index must be in range
+ConcurrentNode* ConcurrentCanvas::nodeAt(int idx) const {
+    ConcurrentNode *curr = head.load(memory_order_relaxed);
+    for (int i = 0; i < idx; i++) {
+        curr = curr->next.load(memory_order_relaxed);
+    }
+    return curr;
+}
+
+// publishes node after prev, or at the front if prev is nullpointer
+// an empty list has no tail, so the first node always becomes it
+void ConcurrentCanvas::link(ConcurrentNode *prev, ConcurrentNode *node) {
+    atomic<ConcurrentNode *> &slot = prev == nullptr ? head : prev->next;
+    node->next.store(slot.load(memory_order_relaxed), memory_order_relaxed);
+    slot.store(node, memory_order_release);
+    if (prev == tail) {
+        tail = node;
+    }
+    count.fetch_add(1, memory_order_release);
+}
+
+// removes every shape
+// nodes are freed once readers still walking them have finished
+void ConcurrentCanvas::clear() {
+    lock_guard<mutex> lock(writeLock);
+    ConcurrentNode *curr = head.exchange(nullptr, memory_order_acq_rel);
+    tail = nullptr;
+    count.store(0, memory_order_release);
+    while (curr != nullptr) {
+        ConcurrentNode *next = curr->next.load(memory_order_relaxed);
+        epochs.retire(curr, destroyNode);
+        curr = next;
+    }
+}
+
+// inserts shape after given index, the canvas takes ownership of it
+// does nothing if index is out of range
+void ConcurrentCanvas::insertAfter(int idx, Shape *shape) {
+    lock_guard<mutex> lock(writeLock);
+    if (idx < 0 || idx >= count.load(memory_order_relaxed)) {
+        return;
+    }
+    link(nodeAt(idx), new ConcurrentNode{shape, {nullptr}});
+}
+
+// pushes shape to front of canvas, the canvas takes ownership of it
+void ConcurrentCanvas::push_front(Shape *shape) {
+    lock_guard<mutex> lock(writeLock);
+    link(nullptr, new ConcurrentNode{shape, {nullptr}});
+}
+
+// pushes shape to back of canvas, the canvas takes ownership of it
+void ConcurrentCanvas::push_back(Shape *shape) {
+    lock_guard<mutex> lock(writeLock);
+    link(tail, new ConcurrentNode{shape, {nullptr}});
+}
+
+// removes shape at given index
+// the node keeps its link so a reader standing on it can carry on
+// does nothing if index is out of range
+void ConcurrentCanvas::removeAt(int idx) {
+    lock_guard<mutex> lock(writeLock);
+    if (idx < 0 || idx >= count.load(memory_order_relaxed)) {
+        return;
+    }
+    ConcurrentNode *prev = idx == 0 ? nullptr : nodeAt(idx - 1);
+    atomic<ConcurrentNode *> &slot = prev == nullptr ? head : prev->next;
+    ConcurrentNode *node = slot.load(memory_order_relaxed);
+    slot.store(node->next.load(memory_order_relaxed), memory_order_release);
+    if (node == tail) {
+        tail = prev;
+    }
+    count.fetch_sub(1, memory_order_release);
+    epochs.retire(node, destroyNode);
+}
+
+// returns true if canvas is empty and false if it is not
+bool ConcurrentCanvas::isempty() const {
+    return size() == 0;
+}
+
+// returns number of shapes in canvas
+int ConcurrentCanvas::size() const {
+    return count.load(memory_order_acquire);
+}
+
+// finds index of shape with given points
+// returns -1 if shape not found
+// return index if shape is found
+int ConcurrentCanvas::find(int x, int y) const {
+    EpochGuard guard(epochs);
+    int idx = 0;
+    for (ConcurrentNode *curr = head.load(memory_order_acquire); curr != nullptr;
+         curr = curr->next.load(memory_order_acquire)) {
+        if (curr->value->getX() == x && curr->value->getY() == y) {
+            return idx;
+        }
+        idx++;
+    }
+    return -1;
+}
+
+// fills record with the shape at given index
+// returns false if index is out of range
+bool ConcurrentCanvas::shapeAt(int idx, ShapeRecord &record) const {
+    if (idx < 0) {
+        return false;
+    }
+    EpochGuard guard(epochs);
+    ConcurrentNode *curr = head.load(memory_order_acquire);
+    for (int i = 0; i < idx && curr != nullptr; i++) {
+        curr = curr->next.load(memory_order_acquire);
+    }
+    if (curr == nullptr) {
+        return false;
+    }
+    record = ShapeRecord::fromShape(*curr->value);
+    return true;
+}
+
+// draws all shapes in canvas to standard output
+void ConcurrentCanvas::draw() const {
+    draw(cout);
+    cout.flush();
+}
+
+// draws all shapes in canvas to out, one printShape line per shape
+void ConcurrentCanvas::draw(ostream &out) const {
+    BlockWriter writer(out);
+    EpochGuard guard(epochs);
+    for (ConcurrentNode *curr = head.load(memory_order_acquire); curr != nullptr;
+         curr = curr->next.load(memory_order_acquire)) {
+        curr->value->printShape(writer.text());
+        writer.endLine();
+    }
+}
+
+// returns the number of removed nodes not yet freed
+size_t ConcurrentCanvas::pendingReclaim() const {
+    lock_guard<mutex> lock(writeLock);
+    return epochs.pending();
+}
@@ -0,0 +1,68 @@
+/// @file concurrentcanvas.h
+/// @date October 2, 2023
+/// @brief The concurrentcanvas file contains declarations for the
+///     ConcurrentCanvas class, a canvas many threads can read while one
+///     thread changes it. Readers follow atomic links without locking;
+///     removed nodes and shapes are freed by an EpochReclaimer once no
+///     reader can reach them.
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <ostream>
+#include "shape.h"
+#include "canvasfile.h"
+#include "epochreclaimer.h"
+
+using namespace std;
+
+// ConcurrentNode struct is one link of the shared list
+// value never changes after the node is published
+struct ConcurrentNode
+{
+    Shape *value;
+    atomic<ConcurrentNode *> next;
+};
+
+// The ConcurrentCanvas class has the CanvasList operations split between
+// writers and readers. Writers take a lock among themselves; readers
+// (isempty, size, find, shapeAt and draw) never block. A reader running
+// alongside a writer sees each write either completely or not at all.
+// Shapes are read back as ShapeRecords because a pointer into the canvas
+// could be freed as soon as the reader returned.
+class ConcurrentCanvas
+{
+    private:
+        atomic<ConcurrentNode *> head;
+        ConcurrentNode *tail;
+        atomic<int> count;
+        mutable mutex writeLock;
+        mutable EpochReclaimer epochs;
+
+        static void destroyNode(void *);
+        ConcurrentNode* nodeAt(int) const;
+        void link(ConcurrentNode *prev, ConcurrentNode *node);
+
+    public:
+        ConcurrentCanvas();
+        ConcurrentCanvas(const ConcurrentCanvas &) = delete;
+        ConcurrentCanvas& operator=(const ConcurrentCanvas &) = delete;
+        ~ConcurrentCanvas();
+
+        void clear();
+        void insertAfter(int, Shape *);
+        void push_front(Shape *);
+        void push_back(Shape *);
+        void removeAt(int);
+
+        bool isempty() const;
+        int size() const;
+        int find(int x, int y) const;
+        bool shapeAt(int, ShapeRecord &) const;
+
+        void draw() const;
+        void draw(ostream &) const;
+
+        size_t pendingReclaim() const;
+};
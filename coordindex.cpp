@@ -0,0 +1,107 @@
+// This file contains all the implementation functions used in coordindex.h
+// It keeps nodes bucketed by the x,y origin of their shape
+
+#include "coordindex.h"
+#include "canvaslist.h"
+using namespace std;
+
+// mixes the packed key so nearby points land in different buckets
+size_t CoordIndex::KeyHash::operator()(unsigned long long key) const {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return static_cast<size_t>(key);
+}
+
+// packs both coordinates into one 64 bit key
+unsigned long long CoordIndex::key(int x, int y) {
+    return (static_cast<unsigned long long>(static_cast<unsigned int>(x)) << 32) | static_cast<unsigned int>(y);
+}
+
+// Default constructor : initializes an empty index
+CoordIndex::CoordIndex() : count(0) {}
+
+// adds node under the current origin of its shape
+void CoordIndex::insert(ShapeNode *node) {
+    buckets[key(node->value->getX(), node->value->getY())].push_back(node);
+    count++;
+}
+
+// removes node from the bucket stored under k
+// drops the bucket once it is empty
+void CoordIndex::removeFrom(unsigned long long k, ShapeNode *node) {
+    auto it = buckets.find(k);
+    if (it == buckets.end()) {
+        return;
+    }
+
+    vector<ShapeNode *> &bucket = it->second;
+    for (size_t i = 0; i < bucket.size(); i++) {
+        if (bucket[i] == node) {
+            // order inside a bucket does not matter so swap with the last
+            bucket[i] = bucket.back();
+            bucket.pop_back();
+            count--;
+            break;
+        }
+    }
+
+    if (bucket.empty()) {
+        buckets.erase(it);
+    }
+}
+
+// removes node using the current origin of its shape
+void CoordIndex::remove(ShapeNode *node) {
+    removeFrom(key(node->value->getX(), node->value->getY()), node);
+}
+
+// moves the node holding shape from its old origin to its current one
+void CoordIndex::move(Shape *shape, int oldX, int oldY) {
+    unsigned long long oldKey = key(oldX, oldY);
+    unsigned long long newKey = key(shape->getX(), shape->getY());
+    if (oldKey == newKey) {
+        return;
+    }
+
+    auto it = buckets.find(oldKey);
+    if (it == buckets.end()) {
+        return;
+    }
+    for (ShapeNode *node : it->second) {
+        if (node->value == shape) {
+            removeFrom(oldKey, node);
+            insert(node);
+            return;
+        }
+    }
+}
+
+// removes every node from the index
+void CoordIndex::clear() {
+    buckets.clear();
+    count = 0;
+}
+
+// returns the node at x,y that comes first in list order
+// returns nullpointer if no shape sits at x,y
+// node positions must be up to date
+ShapeNode* CoordIndex::first(int x, int y) const {
+    auto it = buckets.find(key(x, y));
+    if (it == buckets.end()) {
+        return nullptr;
+    }
+
+    ShapeNode *best = nullptr;
+    for (ShapeNode *node : it->second) {
+        if (best == nullptr || node->position < best->position) {
+            best = node;
+        }
+    }
+    return best;
+}
+
+// returns the number of indexed nodes
+int CoordIndex::size() const {
+    return count;
+}
@@ -0,0 +1,45 @@
+/// @file coordindex.h
+/// @date October 2, 2023
+/// @brief The coordindex file contains declarations for the CoordIndex
+///     class, a hash index from (x, y) origins to the CanvasList nodes
+///     whose shape sits at that point. CanvasList keeps it up to date
+///     and uses it to answer find() without walking the list.
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+class Shape;
+class ShapeNode;
+
+// The CoordIndex class buckets nodes by the origin of their shape.
+// Each bucket may hold several nodes in no particular order; the first
+// one in list order is picked by comparing node positions.
+class CoordIndex
+{
+    private:
+        struct KeyHash
+        {
+            size_t operator()(unsigned long long key) const;
+        };
+
+        unordered_map<unsigned long long, vector<ShapeNode *>, KeyHash> buckets;
+        int count;
+
+        static unsigned long long key(int x, int y);
+        void removeFrom(unsigned long long, ShapeNode *);
+
+    public:
+        CoordIndex();
+
+        void insert(ShapeNode *);
+        void remove(ShapeNode *);
+        void move(Shape *, int oldX, int oldY);
+        void clear();
+
+        ShapeNode* first(int x, int y) const;
+        int size() const;
+};
@@ -0,0 +1,300 @@
+// This file contains all the implementation functions used in cowcanvas.h
+// Every function that changes the canvas goes through editTable or
+// editChunk before writing, which is what keeps copies apart
+
+#include "cowcanvas.h"
+#include <iostream>
+#include "blockwriter.h"
+using namespace std;
+
+// Default constructor : initializes empty chunk
+CowChunk::CowChunk() {}
+
+// Copy Constructor : deep copies every shape of another chunk
+CowChunk::CowChunk(const CowChunk &other) {
+    shapes.reserve(CowCanvas::CHUNK_SHAPES);
+    for (Shape *shape : other.shapes) {
+        shapes.push_back(shape->copy());
+    }
+}
+
+// Destructor that deallocates memory for all shapes in the chunk
+CowChunk::~CowChunk() {
+    for (Shape *shape : shapes) {
+        delete shape;
+    }
+}
+
+// Default constructor : initializes empty cowCanvas
+CowCanvas::CowCanvas() : table(make_shared<ChunkTable>()), count(0) {}
+
+// Conversion Constructor : creates new cowCanvas holding copies of a canvasList's shapes
+CowCanvas::CowCanvas(const CanvasList &list) : CowCanvas() {
+    for (ShapeNode *curr = list.front(); curr != nullptr; curr = curr->next) {
+        push_back(curr->value->copy());
+    }
+}
+
+// returns the chunk table, copying it first if another canvas shares it
+// the copy shares every chunk, so it costs one pointer per chunk
+CowCanvas::ChunkTable& CowCanvas::editTable() {
+    if (table.use_count() > 1) {
+        table = make_shared<ChunkTable>(*table);
+    }
+    return *table;
+}
+
+// returns a chunk only this canvas holds, cloning it first if needed
+CowChunk& CowCanvas::editChunk(int chunk) {
+    shared_ptr<CowChunk> &slot = editTable()[chunk];
+    if (slot.use_count() > 1) {
+        slot = make_shared<CowChunk>(*slot);
+    }
+    return *slot;
+}
+
+// finds the chunk holding the shape at idx and its offset inside it
+// idx must be in range
+void CowCanvas::locate(int idx, int &chunk, int &offset) const {
+    // walks from whichever end of the table is closer
+    if (idx < count / 2) {
+        chunk = 0;
+        while (idx >= static_cast<int>((*table)[chunk]->shapes.size())) {
+            idx -= (*table)[chunk]->shapes.size();
+            chunk++;
+        }
+        offset = idx;
+        return;
+    }
+    int fromBack = count - 1 - idx;
+    chunk = static_cast<int>(table->size()) - 1;
+    while (fromBack >= static_cast<int>((*table)[chunk]->shapes.size())) {
+        fromBack -= (*table)[chunk]->shapes.size();
+        chunk--;
+    }
+    offset = static_cast<int>((*table)[chunk]->shapes.size()) - 1 - fromBack;
+}
+
+// splits a chunk in two halves once it holds more than CHUNK_SHAPES
+// the chunk must already be unshared
+void CowCanvas::splitIfFull(int chunk) {
+    ChunkTable &chunks = *table;
+    vector<Shape *> &shapes = chunks[chunk]->shapes;
+    if (static_cast<int>(shapes.size()) <= CHUNK_SHAPES) {
+        return;
+    }
+    shared_ptr<CowChunk> upper = make_shared<CowChunk>();
+    upper->shapes.assign(shapes.begin() + shapes.size() / 2, shapes.end());
+    shapes.resize(shapes.size() / 2);
+    chunks.insert(chunks.begin() + chunk + 1, upper);
+}
+
+// removes the shape at offset in chunk and returns it, owned by the caller
+// a shape in a shared chunk is copied rather than cloning the whole chunk
+Shape* CowCanvas::takeShape(int chunk, int offset) {
+    ChunkTable &chunks = editTable();
+    Shape *shape;
+    if (chunks[chunk].use_count() > 1) {
+        shared_ptr<CowChunk> rest = make_shared<CowChunk>();
+        for (int i = 0; i < static_cast<int>(chunks[chunk]->shapes.size()); i++) {
+            if (i != offset) {
+                rest->shapes.push_back(chunks[chunk]->shapes[i]->copy());
+            }
+        }
+        shape = chunks[chunk]->shapes[offset]->copy();
+        chunks[chunk] = rest;
+    }
+    else {
+        vector<Shape *> &shapes = chunks[chunk]->shapes;
+        shape = shapes[offset];
+        shapes.erase(shapes.begin() + offset);
+    }
+
+    if (chunks[chunk]->shapes.empty()) {
+        chunks.erase(chunks.begin() + chunk);
+    }
+    count--;
+    return shape;
+}
+
+// clears the canvas
+// chunks still used by copies stay alive for them
+void CowCanvas::clear() {
+    table = make_shared<ChunkTable>();
+    count = 0;
+}
+
+// inserts shape after given index, the canvas takes ownership of it
+// does nothing if index is out of range
+void CowCanvas::insertAfter(int idx, Shape *shape) {
+    if (idx < 0 || idx >= count) {
+        return;
+    }
+    int chunk;
+    int offset;
+    locate(idx, chunk, offset);
+    vector<Shape *> &shapes = editChunk(chunk).shapes;
+    shapes.insert(shapes.begin() + offset + 1, shape);
+    count++;
+    splitIfFull(chunk);
+}
+
+// pushes shape to front of canvas, the canvas takes ownership of it
+void CowCanvas::push_front(Shape *shape) {
+    ChunkTable &chunks = editTable();
+    if (chunks.empty() || static_cast<int>(chunks.front()->shapes.size()) >= CHUNK_SHAPES) {
+        chunks.insert(chunks.begin(), make_shared<CowChunk>());
+    }
+    vector<Shape *> &shapes = editChunk(0).shapes;
+    shapes.insert(shapes.begin(), shape);
+    count++;
+}
+
+// pushes shape to back of canvas, the canvas takes ownership of it
+void CowCanvas::push_back(Shape *shape) {
+    ChunkTable &chunks = editTable();
+    if (chunks.empty() || static_cast<int>(chunks.back()->shapes.size()) >= CHUNK_SHAPES) {
+        chunks.push_back(make_shared<CowChunk>());
+        chunks.back()->shapes.reserve(CHUNK_SHAPES);
+    }
+    editChunk(static_cast<int>(chunks.size()) - 1).shapes.push_back(shape);
+    count++;
+}
+
+// removes and deletes shape at given index
+// does nothing if index is out of range
+void CowCanvas::removeAt(int idx) {
+    if (idx < 0 || idx >= count) {
+        return;
+    }
+    int chunk;
+    int offset;
+    locate(idx, chunk, offset);
+    delete takeShape(chunk, offset);
+}
+
+// removes every other shape starting with index 1
+// shared chunks are rebuilt from copies of the kept shapes only
+void CowCanvas::removeEveryOther() {
+    ChunkTable &chunks = editTable();
+    ChunkTable kept;
+    int idx = 0;
+    for (shared_ptr<CowChunk> &chunk : chunks) {
+        bool shared = chunk.use_count() > 1;
+        shared_ptr<CowChunk> result = shared ? make_shared<CowChunk>() : chunk;
+        int keptInChunk = 0;
+        for (Shape *shape : chunk->shapes) {
+            if (idx % 2 == 0) {
+                if (shared) {
+                    result->shapes.push_back(shape->copy());
+                }
+                else {
+                    result->shapes[keptInChunk] = shape;
+                }
+                keptInChunk++;
+            }
+            else if (!shared) {
+                delete shape;
+            }
+            idx++;
+        }
+        result->shapes.resize(keptInChunk);
+        if (keptInChunk > 0) {
+            kept.push_back(result);
+        }
+    }
+    chunks.swap(kept);
+    count = (count + 1) / 2;
+}
+
+// pops and returns the front of canvas shape, owned by the caller
+// returns nullpointer if canvas is empty
+Shape* CowCanvas::pop_front() {
+    if (isempty()) {
+        return nullptr;
+    }
+    return takeShape(0, 0);
+}
+
+// pops and returns the back of canvas shape, owned by the caller
+// returns nullpointer if canvas is empty
+Shape* CowCanvas::pop_back() {
+    if (isempty()) {
+        return nullptr;
+    }
+    int chunk = static_cast<int>(table->size()) - 1;
+    return takeShape(chunk, static_cast<int>((*table)[chunk]->shapes.size()) - 1);
+}
+
+// returns true if canvas is empty and false if it is not
+bool CowCanvas::isempty() const {
+    return count == 0;
+}
+
+// returns number of shapes in canvas
+int CowCanvas::size() const {
+    return count;
+}
+
+// returns number of chunks the shapes are split into
+int CowCanvas::chunkCount() const {
+    return static_cast<int>(table->size());
+}
+
+// finds index of shape with given points
+// returns -1 if shape not found
+// return index if shape is found
+int CowCanvas::find(int x, int y) const {
+    int idx = 0;
+    for (const shared_ptr<CowChunk> &chunk : *table) {
+        for (Shape *shape : chunk->shapes) {
+            if (shape->getX() == x && shape->getY() == y) {
+                return idx;
+            }
+            idx++;
+        }
+    }
+    return -1;
+}
+
+// returns pointer to shape at given index for reading
+// returns nullpointer if index is out of range
+const Shape* CowCanvas::shapeAt(int idx) const {
+    if (idx < 0 || idx >= count) {
+        return nullptr;
+    }
+    int chunk;
+    int offset;
+    locate(idx, chunk, offset);
+    return (*table)[chunk]->shapes[offset];
+}
+
+// returns pointer to shape at given index that may be changed
+// clones the shape's chunk first if a copy shares it
+// returns nullpointer if index is out of range
+Shape* CowCanvas::editAt(int idx) {
+    if (idx < 0 || idx >= count) {
+        return nullptr;
+    }
+    int chunk;
+    int offset;
+    locate(idx, chunk, offset);
+    return editChunk(chunk).shapes[offset];
+}
+
+// draws all shapes in canvas to standard output
+void CowCanvas::draw() const {
+    draw(cout);
+    cout.flush();
+}
+
+// draws all shapes in canvas to out, one printShape line per shape
+void CowCanvas::draw(ostream &out) const {
+    BlockWriter writer(out);
+    for (const shared_ptr<CowChunk> &chunk : *table) {
+        for (Shape *shape : chunk->shapes) {
+            shape->printShape(writer.text());
+            writer.endLine();
+        }
+    }
+}
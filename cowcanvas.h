@@ -0,0 +1,77 @@
+/// @file cowcanvas.h
+/// @date October 2, 2023
+/// @brief The cowcanvas file contains declarations for the CowCanvas
+///     class, a copy-on-write sibling of CanvasList. Shapes are kept in
+///     chunks that copies share, so copying a canvas is constant time and
+///     a later edit clones only the chunk it touches.
+
+#pragma once
+
+#include <memory>
+#include <ostream>
+#include <vector>
+#include "shape.h"
+#include "canvaslist.h"
+
+using namespace std;
+
+// CowChunk struct owns up to CowCanvas::CHUNK_SHAPES shapes in order
+// copying a chunk deep copies its shapes
+struct CowChunk
+{
+    vector<Shape *> shapes;
+
+    CowChunk();
+    CowChunk(const CowChunk &);
+    CowChunk& operator=(const CowChunk &) = delete;
+    ~CowChunk();
+};
+
+// The CowCanvas class has the CanvasList operations with value semantics.
+// Copies share one table of chunks until one of them changes; the table
+// is then copied and each chunk the change touches is cloned first.
+// Shapes read through shapeAt must not be changed; editAt unshares the
+// shape and returns one that may be.
+// CowCanvas is not thread safe, including copies that share chunks.
+class CowCanvas
+{
+    private:
+        typedef vector<shared_ptr<CowChunk>> ChunkTable;
+
+        shared_ptr<ChunkTable> table;
+        int count;
+
+        ChunkTable& editTable();
+        CowChunk& editChunk(int chunk);
+        void locate(int idx, int &chunk, int &offset) const;
+        void splitIfFull(int chunk);
+        Shape* takeShape(int chunk, int offset);
+
+    public:
+        static constexpr int CHUNK_SHAPES = 256;
+
+        CowCanvas();
+        explicit CowCanvas(const CanvasList &);
+
+        void clear();
+
+        void insertAfter(int, Shape *);
+        void push_front(Shape *);
+        void push_back(Shape *);
+
+        void removeAt(int);
+        void removeEveryOther();
+        Shape* pop_front();
+        Shape* pop_back();
+
+        bool isempty() const;
+        int size() const;
+        int chunkCount() const;
+
+        int find(int x, int y) const;
+        const Shape* shapeAt(int) const;
+        Shape* editAt(int);
+
+        void draw() const;
+        void draw(ostream &) const;
+};
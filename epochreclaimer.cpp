@@ -0,0 +1,108 @@
+// This file contains all the implementation functions used in epochreclaimer.h
+// The seq_cst fences in enter and collect pair up: either collect sees the
+// reader's slot, or the reader sees every unlink made before collect ran
+
+#include "epochreclaimer.h"
+#include <functional>
+#include <thread>
+using namespace std;
+
+// Default constructor : starts at epoch 1 so 0 can mean idle
+EpochReclaimer::EpochReclaimer() : globalEpoch(1) {
+    for (Slot &slot : slots) {
+        slot.epoch.store(0, memory_order_relaxed);
+        slot.used.store(false, memory_order_relaxed);
+    }
+}
+
+// Destructor that destroys everything still retired
+// no reader may hold a guard any more
+EpochReclaimer::~EpochReclaimer() {
+    for (Retired &item : retired) {
+        item.destroy(item.object);
+    }
+}
+
+// claims a free slot and announces the current epoch in it
+// returns the slot's number
+int EpochReclaimer::enter() {
+    size_t start = hash<thread::id>()(this_thread::get_id());
+    for (size_t i = 0; ; i++) {
+        int idx = static_cast<int>((start + i) % MAX_READERS);
+        Slot &slot = slots[idx];
+        bool expected = false;
+        if (!slot.used.load(memory_order_relaxed) &&
+            slot.used.compare_exchange_strong(expected, true, memory_order_acquire)) {
+            slot.epoch.store(globalEpoch.load(memory_order_acquire), memory_order_relaxed);
+            atomic_thread_fence(memory_order_seq_cst);
+            return idx;
+        }
+        // only more than MAX_READERS simultaneous readers get here twice
+        if (i % MAX_READERS == MAX_READERS - 1) {
+            this_thread::yield();
+        }
+    }
+}
+
+// marks the slot idle and frees it for another reader
+void EpochReclaimer::leave(int idx) {
+    slots[idx].epoch.store(0, memory_order_release);
+    slots[idx].used.store(false, memory_order_release);
+}
+
+// queues an unlinked object to be destroyed with destroy(object)
+// collects once enough objects are waiting
+void EpochReclaimer::retire(void *object, void (*destroy)(void *)) {
+    lock_guard<mutex> lock(retiredLock);
+    retired.push_back(Retired{object, destroy, globalEpoch.load(memory_order_relaxed)});
+    if (retired.size() >= COLLECT_THRESHOLD) {
+        collectLocked();
+    }
+}
+
+// advances the epoch and destroys every retired object that no current
+// reader announced an epoch old enough to have seen
+void EpochReclaimer::collect() {
+    lock_guard<mutex> lock(retiredLock);
+    collectLocked();
+}
+
+// does the work of collect for a caller already holding retiredLock
+void EpochReclaimer::collectLocked() {
+    globalEpoch.fetch_add(1, memory_order_acq_rel);
+    atomic_thread_fence(memory_order_seq_cst);
+
+    uint64_t oldest = UINT64_MAX;
+    for (Slot &slot : slots) {
+        uint64_t epoch = slot.epoch.load(memory_order_acquire);
+        if (epoch != 0 && epoch < oldest) {
+            oldest = epoch;
+        }
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < retired.size(); i++) {
+        if (retired[i].epoch < oldest) {
+            retired[i].destroy(retired[i].object);
+        }
+        else {
+            retired[kept] = retired[i];
+            kept++;
+        }
+    }
+    retired.resize(kept);
+}
+
+// returns the number of retired objects not yet destroyed
+size_t EpochReclaimer::pending() const {
+    lock_guard<mutex> lock(retiredLock);
+    return retired.size();
+}
+
+// Parameter constructor : enters domain as a reader
+EpochGuard::EpochGuard(EpochReclaimer &domain) : domain(domain), slot(domain.enter()) {}
+
+// Destructor that leaves the domain
+EpochGuard::~EpochGuard() {
+    domain.leave(slot);
+}
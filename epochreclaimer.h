@@ -0,0 +1,81 @@
+/// @file epochreclaimer.h
+/// @date October 2, 2023
+/// @brief The epochreclaimer file contains declarations for the
+///     EpochReclaimer class that frees memory unlinked from a shared
+///     structure only once no reader can still be looking at it. Readers
+///     announce themselves with an EpochGuard and never wait for anyone.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+// The EpochReclaimer class implements epoch based reclamation.
+// A reader holds an EpochGuard for as long as it follows pointers into the
+// structure. A writer unlinks an object, then hands it to retire(); it is
+// destroyed by a later collect() once every guard that could have seen it
+// has been released. retire and collect may be called from any thread;
+// they share a short lock that readers never touch.
+class EpochReclaimer
+{
+    private:
+        // more simultaneous readers than this take turns for slots
+        static constexpr int MAX_READERS = 128;
+
+        // Slot struct is one reader's announcement, 0 when idle
+        // slots sit on their own cache lines so readers do not collide
+        struct alignas(64) Slot
+        {
+            atomic<uint64_t> epoch;
+            atomic<bool> used;
+        };
+
+        // Retired struct is one unlinked object waiting to be destroyed
+        struct Retired
+        {
+            void *object;
+            void (*destroy)(void *);
+            uint64_t epoch;
+        };
+
+        Slot slots[MAX_READERS];
+        atomic<uint64_t> globalEpoch;
+        mutable mutex retiredLock;
+        vector<Retired> retired;
+
+        int enter();
+        void leave(int slot);
+        void collectLocked();
+
+        friend class EpochGuard;
+
+    public:
+        static constexpr size_t COLLECT_THRESHOLD = 64;
+
+        EpochReclaimer();
+        EpochReclaimer(const EpochReclaimer &) = delete;
+        EpochReclaimer& operator=(const EpochReclaimer &) = delete;
+        ~EpochReclaimer();
+
+        void retire(void *object, void (*destroy)(void *));
+        void collect();
+        size_t pending() const;
+};
+
+// The EpochGuard class marks the current thread as a reader while it lives
+class EpochGuard
+{
+    private:
+        EpochReclaimer &domain;
+        int slot;
+
+    public:
+        explicit EpochGuard(EpochReclaimer &);
+        EpochGuard(const EpochGuard &) = delete;
+        EpochGuard& operator=(const EpochGuard &) = delete;
+        ~EpochGuard();
+};
@@ -0,0 +1,110 @@
+// This file contains all the implementation functions used in framebuffer.h
+// It stores pixels and writes them out as PPM or PGM images
+
+#include "framebuffer.h"
+#include <algorithm>
+#include <fstream>
+using namespace std;
+
+// Parameter constructor : initializes a black, fully transparent image
+// negative sizes are treated as 0
+Framebuffer::Framebuffer(int width, int height)
+    : width(max(0, width)), height(max(0, height)), pixels(static_cast<size_t>(max(0, width)) * max(0, height), 0) {}
+
+// packs color channels into one pixel
+uint32_t Framebuffer::rgba(int r, int g, int b, int a) {
+    return static_cast<uint32_t>(r & 0xff) | static_cast<uint32_t>(g & 0xff) << 8 |
+           static_cast<uint32_t>(b & 0xff) << 16 | static_cast<uint32_t>(a & 0xff) << 24;
+}
+
+int Framebuffer::getWidth() const {
+    return width;
+}
+
+int Framebuffer::getHeight() const {
+    return height;
+}
+
+// returns the pixel at x,y
+// returns 0 if x,y is outside the image
+uint32_t Framebuffer::getPixel(int x, int y) const {
+    if (x < 0 || x >= width || y < 0 || y >= height) {
+        return 0;
+    }
+    return pixels[static_cast<size_t>(y) * width + x];
+}
+
+// returns the first pixel of row y, which must be in range
+uint32_t* Framebuffer::row(int y) {
+    return pixels.data() + static_cast<size_t>(y) * width;
+}
+
+const uint32_t* Framebuffer::row(int y) const {
+    return pixels.data() + static_cast<size_t>(y) * width;
+}
+
+// sets every pixel to color
+void Framebuffer::clear(uint32_t color) {
+    fill(pixels.begin(), pixels.end(), color);
+}
+
+// sets pixels minX through maxX of row y to color
+// the span is clipped to the image
+void Framebuffer::fillSpan(int y, int minX, int maxX, uint32_t color) {
+    if (y < 0 || y >= height) {
+        return;
+    }
+    minX = max(minX, 0);
+    maxX = min(maxX, width - 1);
+    if (minX > maxX) {
+        return;
+    }
+    // one contiguous run of stores that the compiler turns into vector writes
+    fill_n(row(y) + minX, maxX - minX + 1, color);
+}
+
+// writes the image as a binary PPM file, dropping alpha
+// returns false if the file could not be written
+bool Framebuffer::writePPM(const string &path) const {
+    ofstream out(path, ios::binary);
+    if (!out) {
+        return false;
+    }
+    out << "P6\n" << width << " " << height << "\n255\n";
+
+    vector<char> line(static_cast<size_t>(width) * 3);
+    for (int y = 0; y < height; y++) {
+        const uint32_t *src = row(y);
+        for (int x = 0; x < width; x++) {
+            line[x * 3] = static_cast<char>(src[x] & 0xff);
+            line[x * 3 + 1] = static_cast<char>((src[x] >> 8) & 0xff);
+            line[x * 3 + 2] = static_cast<char>((src[x] >> 16) & 0xff);
+        }
+        out.write(line.data(), line.size());
+    }
+    return static_cast<bool>(out);
+}
+
+// writes the image as a binary PGM file using each pixel's luma
+// returns false if the file could not be written
+bool Framebuffer::writePGM(const string &path) const {
+    ofstream out(path, ios::binary);
+    if (!out) {
+        return false;
+    }
+    out << "P5\n" << width << " " << height << "\n255\n";
+
+    vector<char> line(width);
+    for (int y = 0; y < height; y++) {
+        const uint32_t *src = row(y);
+        for (int x = 0; x < width; x++) {
+            int r = src[x] & 0xff;
+            int g = (src[x] >> 8) & 0xff;
+            int b = (src[x] >> 16) & 0xff;
+            // integer Rec. 601 weights
+            line[x] = static_cast<char>((r * 77 + g * 150 + b * 29) >> 8);
+        }
+        out.write(line.data(), line.size());
+    }
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,41 @@
+/// @file framebuffer.h
+/// @date October 2, 2023
+/// @brief The framebuffer file contains declarations for the Framebuffer
+///     class, an in-memory RGBA image that shapes are rasterized into.
+///     It can be saved as a binary PPM (color) or PGM (gray) file so the
+///     result can be checked without a display.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// The Framebuffer class stores width * height pixels row by row.
+// Each pixel is packed as 0xAABBGGRR so its bytes read R, G, B, A in memory.
+class Framebuffer
+{
+    private:
+        int width;
+        int height;
+        vector<uint32_t> pixels;
+
+    public:
+        Framebuffer(int width, int height);
+
+        static uint32_t rgba(int r, int g, int b, int a = 255);
+
+        int getWidth() const;
+        int getHeight() const;
+        uint32_t getPixel(int x, int y) const;
+        uint32_t* row(int y);
+        const uint32_t* row(int y) const;
+
+        void clear(uint32_t color);
+        void fillSpan(int y, int minX, int maxX, uint32_t color);
+
+        bool writePPM(const string &path) const;
+        bool writePGM(const string &path) const;
+};
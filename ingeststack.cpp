@@ -0,0 +1,103 @@
+// This file contains all the implementation functions used in ingeststack.h
+
+#include "ingeststack.h"
+using namespace std;
+
+// Default constructor : initializes empty ingestStack
+IngestStack::IngestStack() : head(nullptr), count(0) {}
+
+// Destructor that deallocates memory for all nodes and shapes still pushed
+// no thread may still be using the stack
+IngestStack::~IngestStack() {
+    IngestNode *curr = head.load(memory_order_relaxed);
+    while (curr != nullptr) {
+        IngestNode *next = curr->next;
+        delete curr->value;
+        delete curr;
+        curr = next;
+    }
+}
+
+// deletes a retired node, its shape has already been handed out
+void IngestStack::destroyNode(void *object) {
+    delete static_cast<IngestNode *>(object);
+}
+
+// deletes a retired batch of nodes taken by moveInto
+void IngestStack::destroyChain(void *object) {
+    vector<IngestNode *> *chain = static_cast<vector<IngestNode *> *>(object);
+    for (IngestNode *node : *chain) {
+        delete node;
+    }
+    delete chain;
+}
+
+// pushes shape on top of the stack, the stack takes ownership of it
+// safe to call from any number of threads at once
+void IngestStack::push_front(Shape *shape) {
+    IngestNode *node = new IngestNode{shape, head.load(memory_order_relaxed)};
+    // counted before it is published, so whoever takes the node decrements
+    // after this and the count never goes below zero
+    count.fetch_add(1, memory_order_relaxed);
+    // a failed exchange reloads node->next with the current head
+    while (!head.compare_exchange_weak(node->next, node, memory_order_release, memory_order_relaxed)) {
+    }
+}
+
+// pops and returns the most recently pushed shape, owned by the caller
+// returns nullpointer if the stack is empty
+Shape* IngestStack::pop_front() {
+    IngestNode *node;
+    {
+        // the guard keeps node alive while its next link is read
+        EpochGuard guard(epochs);
+        node = head.load(memory_order_acquire);
+        while (node != nullptr &&
+               !head.compare_exchange_weak(node, node->next, memory_order_acquire, memory_order_acquire)) {
+        }
+    }
+    if (node == nullptr) {
+        return nullptr;
+    }
+    count.fetch_sub(1, memory_order_relaxed);
+    Shape *shape = node->value;
+    epochs.retire(node, destroyNode);
+    return shape;
+}
+
+// takes every pushed shape and prepends them to list
+// the newest shape ends up at the front, as if each push had gone to list
+// returns the number of shapes moved
+int IngestStack::moveInto(CanvasList &list) {
+    IngestNode *curr;
+    {
+        EpochGuard guard(epochs);
+        curr = head.exchange(nullptr, memory_order_acquire);
+    }
+
+    // the chain runs newest to oldest, so it is replayed from the end
+    // poppers may still be reading its nodes, so they are retired as one batch
+    vector<IngestNode *> *chain = new vector<IngestNode *>();
+    for (; curr != nullptr; curr = curr->next) {
+        chain->push_back(curr);
+    }
+    int moved = static_cast<int>(chain->size());
+    count.fetch_sub(moved, memory_order_relaxed);
+    for (auto it = chain->rbegin(); it != chain->rend(); ++it) {
+        list.push_front((*it)->value);
+    }
+    epochs.retire(chain, destroyChain);
+    return moved;
+}
+
+// returns true if the stack looks empty and false if it does not
+bool IngestStack::isempty() const {
+    return head.load(memory_order_acquire) == nullptr;
+}
+
+// returns the number of shapes pushed and not yet taken
+// while producers are pushing the count can briefly include shapes that
+// are not on the stack yet, but it never goes below zero
+int IngestStack::size() const {
+    return count.load(memory_order_relaxed);
+}
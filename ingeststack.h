@@ -0,0 +1,56 @@
+/// @file ingeststack.h
+/// @date October 2, 2023
+/// @brief The ingeststack file contains declarations for the IngestStack
+///     class that lets many producer threads push shapes at once without
+///     a lock. Each push is a single compare and swap on the head
+///     (a Treiber stack) and the finished batch is moved into a
+///     CanvasList in one step.
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include "shape.h"
+#include "canvaslist.h"
+#include "epochreclaimer.h"
+
+using namespace std;
+
+// IngestNode struct is one pushed shape
+// next is fixed before the node is published and never changes after
+struct IngestNode
+{
+    Shape *value;
+    IngestNode *next;
+};
+
+// The IngestStack class collects shapes from many threads.
+// push_front and size never block. pop_front is lock free among poppers;
+// popped nodes go to an EpochReclaimer, so a node another popper is still
+// reading can neither be freed nor come back at the same address, which
+// is what makes the compare and swap safe from ABA. moveInto takes the
+// whole stack with one exchange and prepends it to a CanvasList in the
+// order the same push_front calls on that list would have produced.
+class IngestStack
+{
+    private:
+        atomic<IngestNode *> head;
+        atomic<int> count;
+        EpochReclaimer epochs;
+
+        static void destroyNode(void *);
+        static void destroyChain(void *);
+
+    public:
+        IngestStack();
+        IngestStack(const IngestStack &) = delete;
+        IngestStack& operator=(const IngestStack &) = delete;
+        ~IngestStack();
+
+        void push_front(Shape *);
+        Shape* pop_front();
+        int moveInto(CanvasList &);
+
+        bool isempty() const;
+        int size() const;
+};
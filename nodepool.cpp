@@ -0,0 +1,83 @@
+// This file contains all the implementation functions used in nodepool.h
+// It carves ShapeNodes out of slabs and recycles them through a free list
+
+#include "nodepool.h"
+#include "canvaslist.h"
+using namespace std;
+
+// Slab of nodes : one heap allocation that holds SLAB_NODES nodes
+struct NodePool::Slab
+{
+    Slab *next;
+    ShapeNode nodes[SLAB_NODES];
+};
+
+// Default constructor : initializes pool with no slabs
+NodePool::NodePool() : slabs(nullptr), slabUsed(SLAB_NODES), freeList(nullptr), stats{0, 0, 0, 0} {}
+
+// Destructor that gives every slab back to the heap
+NodePool::~NodePool() {
+    releaseAll();
+}
+
+// returns storage for one node with all members set to nullptr or 0
+// reuses released nodes first, then the newest slab, then a new slab
+ShapeNode* NodePool::allocate() {
+    ShapeNode *node;
+
+    if (freeList != nullptr) {
+        // pops a node off the free list
+        node = freeList;
+        freeList = freeList->next;
+    }
+    else {
+        // requests a new slab once the newest one is used up
+        if (slabUsed == SLAB_NODES) {
+            Slab *slab = new Slab;
+            slab->next = slabs;
+            slabs = slab;
+            slabUsed = 0;
+            stats.slabAllocations++;
+        }
+        node = &slabs->nodes[slabUsed];
+        slabUsed++;
+    }
+
+    node->value = nullptr;
+    node->next = nullptr;
+    node->prev = nullptr;
+    node->position = 0;
+    stats.nodeAllocations++;
+    return node;
+}
+
+// gives a node back to the pool so it can be reused
+// the node's shape is not touched
+void NodePool::release(ShapeNode *node) {
+    node->next = freeList;
+    freeList = node;
+    stats.nodeReleases++;
+}
+
+// gives every slab back to the heap at once
+// all nodes handed out by this pool become invalid
+void NodePool::releaseAll() {
+    while (slabs != nullptr) {
+        Slab *temp = slabs;
+        slabs = slabs->next;
+        delete temp;
+        stats.slabReleases++;
+    }
+    slabUsed = SLAB_NODES;
+    freeList = nullptr;
+}
+
+// returns the number of slabs currently held
+int NodePool::slabCount() const {
+    return stats.slabAllocations - stats.slabReleases;
+}
+
+// returns the allocation counters
+PoolStats NodePool::getStats() const {
+    return stats;
+}
@@ -0,0 +1,50 @@
+/// @file nodepool.h
+/// @date October 2, 2023
+/// @brief The nodepool file contains declarations for the NodePool class
+///     that hands out ShapeNode storage for a CanvasList. Nodes are carved
+///     out of large contiguous slabs and recycled through a free list so
+///     that inserting and removing shapes rarely touches the heap.
+
+#pragma once
+
+class Shape;
+class ShapeNode;
+
+// Counters describing how a NodePool has used the heap
+// slabAllocations is the number of real heap allocations made
+struct PoolStats
+{
+    long slabAllocations;
+    long slabReleases;
+    long nodeAllocations;
+    long nodeReleases;
+};
+
+// The NodePool class is a slab allocator for ShapeNode objects.
+// Released nodes are kept on a free list and reused before a new slab
+// is requested, and releaseAll() gives every slab back in one pass.
+class NodePool
+{
+    private:
+        struct Slab;
+
+        Slab *slabs;
+        int slabUsed;
+        ShapeNode *freeList;
+        PoolStats stats;
+
+    public:
+        static constexpr int SLAB_NODES = 1024;
+
+        NodePool();
+        NodePool(const NodePool &) = delete;
+        NodePool& operator=(const NodePool &) = delete;
+        ~NodePool();
+
+        ShapeNode* allocate();
+        void release(ShapeNode *);
+        void releaseAll();
+
+        int slabCount() const;
+        PoolStats getStats() const;
+};
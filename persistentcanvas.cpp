@@ -0,0 +1,304 @@
+// This file contains all the implementation functions used in persistentcanvas.h
+// Tree helpers never modify a node; they return new nodes that point at
+// the untouched subtrees of the old ones
+
+#include "persistentcanvas.h"
+#include <algorithm>
+#include <iostream>
+#include "blockwriter.h"
+using namespace std;
+
+// returns the number of shapes under node
+static int sizeOf(const PersistentLink &node) {
+    return node == nullptr ? 0 : node->size;
+}
+
+// returns the height of node, 0 for an empty tree
+static int heightOf(const PersistentLink &node) {
+    return node == nullptr ? 0 : node->height;
+}
+
+// returns a new node joining left, shape and right as they are
+static PersistentLink makeNode(const PersistentLink &left, const shared_ptr<Shape> &shape,
+                               const PersistentLink &right) {
+    return make_shared<const PersistentNode>(PersistentNode{
+        shape, left, right, sizeOf(left) + 1 + sizeOf(right), max(heightOf(left), heightOf(right)) + 1});
+}
+
+// returns a node joining left, shape and right, rotating once or twice
+// if their heights differ by two
+static PersistentLink balance(const PersistentLink &left, const shared_ptr<Shape> &shape,
+                              const PersistentLink &right) {
+    if (heightOf(left) > heightOf(right) + 1) {
+        if (heightOf(left->left) >= heightOf(left->right)) {
+            return makeNode(left->left, left->shape, makeNode(left->right, shape, right));
+        }
+        const PersistentLink &pivot = left->right;
+        return makeNode(makeNode(left->left, left->shape, pivot->left), pivot->shape,
+                        makeNode(pivot->right, shape, right));
+    }
+    if (heightOf(right) > heightOf(left) + 1) {
+        if (heightOf(right->right) >= heightOf(right->left)) {
+            return makeNode(makeNode(left, shape, right->left), right->shape, right->right);
+        }
+        const PersistentLink &pivot = right->left;
+        return makeNode(makeNode(left, shape, pivot->left), pivot->shape,
+                        makeNode(pivot->right, right->shape, right->right));
+    }
+    return makeNode(left, shape, right);
+}
+
+// returns a tree with shape inserted so that it ends up at index idx
+static PersistentLink insertAt(const PersistentLink &node, int idx, const shared_ptr<Shape> &shape) {
+    if (node == nullptr) {
+        return makeNode(nullptr, shape, nullptr);
+    }
+    int leftSize = sizeOf(node->left);
+    if (idx <= leftSize) {
+        return balance(insertAt(node->left, idx, shape), node->shape, node->right);
+    }
+    return balance(node->left, node->shape, insertAt(node->right, idx - leftSize - 1, shape));
+}
+
+// returns a tree without its first shape, which is stored in removed
+static PersistentLink removeFirst(const PersistentLink &node, shared_ptr<Shape> &removed) {
+    if (node->left == nullptr) {
+        removed = node->shape;
+        return node->right;
+    }
+    return balance(removeFirst(node->left, removed), node->shape, node->right);
+}
+
+// returns a tree without the shape at index idx, which is stored in removed
+static PersistentLink eraseAt(const PersistentLink &node, int idx, shared_ptr<Shape> &removed) {
+    int leftSize = sizeOf(node->left);
+    if (idx < leftSize) {
+        return balance(eraseAt(node->left, idx, removed), node->shape, node->right);
+    }
+    if (idx > leftSize) {
+        return balance(node->left, node->shape, eraseAt(node->right, idx - leftSize - 1, removed));
+    }
+
+    removed = node->shape;
+    if (node->right == nullptr) {
+        return node->left;
+    }
+    shared_ptr<Shape> successor;
+    PersistentLink right = removeFirst(node->right, successor);
+    return balance(node->left, successor, right);
+}
+
+// returns a tree with the shape at index idx swapped for shape
+static PersistentLink replace(const PersistentLink &node, int idx, const shared_ptr<Shape> &shape) {
+    int leftSize = sizeOf(node->left);
+    if (idx < leftSize) {
+        return makeNode(replace(node->left, idx, shape), node->shape, node->right);
+    }
+    if (idx > leftSize) {
+        return makeNode(node->left, node->shape, replace(node->right, idx - leftSize - 1, shape));
+    }
+    return makeNode(node->left, shape, node->right);
+}
+
+// returns the node holding the shape at index idx
+// idx must be in range
+static const PersistentNode* nodeAt(const PersistentLink &root, int idx) {
+    const PersistentNode *node = root.get();
+    while (true) {
+        int leftSize = sizeOf(node->left);
+        if (idx == leftSize) {
+            return node;
+        }
+        if (idx < leftSize) {
+            node = node->left.get();
+        }
+        else {
+            idx -= leftSize + 1;
+            node = node->right.get();
+        }
+    }
+}
+
+// returns a perfectly balanced tree over shapes[first, last)
+PersistentLink PersistentCanvas::build(const vector<shared_ptr<Shape>> &shapes, int first, int last) {
+    if (first >= last) {
+        return nullptr;
+    }
+    int middle = first + (last - first) / 2;
+    return makeNode(build(shapes, first, middle), shapes[middle], build(shapes, middle + 1, last));
+}
+
+// appends every shape under node to shapes in index order
+void PersistentCanvas::collect(const PersistentLink &node, vector<shared_ptr<Shape>> &shapes) {
+    if (node == nullptr) {
+        return;
+    }
+    collect(node->left, shapes);
+    shapes.push_back(node->shape);
+    collect(node->right, shapes);
+}
+
+// Default constructor : initializes empty persistentCanvas
+PersistentCanvas::PersistentCanvas() {}
+
+// Conversion Constructor : creates new persistentCanvas holding copies of a canvasList's shapes
+PersistentCanvas::PersistentCanvas(const CanvasList &list) {
+    vector<shared_ptr<Shape>> shapes;
+    shapes.reserve(list.size());
+    for (ShapeNode *curr = list.front(); curr != nullptr; curr = curr->next) {
+        shapes.push_back(shared_ptr<Shape>(curr->value->copy()));
+    }
+    root = build(shapes, 0, static_cast<int>(shapes.size()));
+}
+
+// clears this version, other versions keep their shapes
+void PersistentCanvas::clear() {
+    root = nullptr;
+}
+
+// inserts shape after given index, the canvas takes ownership of it
+// does nothing if index is out of range
+void PersistentCanvas::insertAfter(int idx, Shape *shape) {
+    if (idx < 0 || idx >= size()) {
+        return;
+    }
+    root = insertAt(root, idx + 1, shared_ptr<Shape>(shape));
+}
+
+// pushes shape to front of canvas, the canvas takes ownership of it
+void PersistentCanvas::push_front(Shape *shape) {
+    root = insertAt(root, 0, shared_ptr<Shape>(shape));
+}
+
+// pushes shape to back of canvas, the canvas takes ownership of it
+void PersistentCanvas::push_back(Shape *shape) {
+    root = insertAt(root, size(), shared_ptr<Shape>(shape));
+}
+
+// swaps the shape at given index for shape, the canvas takes ownership of it
+// does nothing if index is out of range
+void PersistentCanvas::replaceAt(int idx, Shape *shape) {
+    if (idx < 0 || idx >= size()) {
+        return;
+    }
+    root = replace(root, idx, shared_ptr<Shape>(shape));
+}
+
+// removes shape at given index
+// the shape is deleted once no version holds it
+// does nothing if index is out of range
+void PersistentCanvas::removeAt(int idx) {
+    if (idx < 0 || idx >= size()) {
+        return;
+    }
+    shared_ptr<Shape> removed;
+    root = eraseAt(root, idx, removed);
+}
+
+// removes every other shape starting with index 1
+// the kept shapes are shared with the old version in a freshly built tree
+void PersistentCanvas::removeEveryOther() {
+    vector<shared_ptr<Shape>> shapes;
+    shapes.reserve(size());
+    collect(root, shapes);
+    int kept = 0;
+    for (int idx = 0; idx < static_cast<int>(shapes.size()); idx += 2) {
+        shapes[kept] = shapes[idx];
+        kept++;
+    }
+    root = build(shapes, 0, kept);
+}
+
+// pops the front of canvas shape and returns a copy owned by the caller
+// returns nullpointer if canvas is empty
+Shape* PersistentCanvas::pop_front() {
+    if (isempty()) {
+        return nullptr;
+    }
+    shared_ptr<Shape> removed;
+    root = eraseAt(root, 0, removed);
+    return removed->copy();
+}
+
+// pops the back of canvas shape and returns a copy owned by the caller
+// returns nullpointer if canvas is empty
+Shape* PersistentCanvas::pop_back() {
+    if (isempty()) {
+        return nullptr;
+    }
+    shared_ptr<Shape> removed;
+    root = eraseAt(root, size() - 1, removed);
+    return removed->copy();
+}
+
+// returns true if canvas is empty and false if it is not
+bool PersistentCanvas::isempty() const {
+    return root == nullptr;
+}
+
+// returns number of shapes in canvas
+int PersistentCanvas::size() const {
+    return sizeOf(root);
+}
+
+// returns height of the tree, which stays within 1.44 log2 of the size
+int PersistentCanvas::height() const {
+    return heightOf(root);
+}
+
+// finds index of shape with given points
+// returns -1 if shape not found
+// return index if shape is found
+int PersistentCanvas::find(int x, int y) const {
+    // walks the tree in order with an explicit stack
+    vector<const PersistentNode *> pending;
+    const PersistentNode *node = root.get();
+    int idx = 0;
+    while (node != nullptr || !pending.empty()) {
+        while (node != nullptr) {
+            pending.push_back(node);
+            node = node->left.get();
+        }
+        node = pending.back();
+        pending.pop_back();
+        if (node->shape->getX() == x && node->shape->getY() == y) {
+            return idx;
+        }
+        idx++;
+        node = node->right.get();
+    }
+    return -1;
+}
+
+// returns pointer to shape at given index for reading
+// returns nullpointer if index is out of range
+const Shape* PersistentCanvas::shapeAt(int idx) const {
+    if (idx < 0 || idx >= size()) {
+        return nullptr;
+    }
+    return nodeAt(root, idx)->shape.get();
+}
+
+// draws all shapes in canvas to standard output
+void PersistentCanvas::draw() const {
+    draw(cout);
+    cout.flush();
+}
+
+// draws all shapes in canvas to out, one printShape line per shape
+void PersistentCanvas::draw(ostream &out) const {
+    BlockWriter writer(out);
+    vector<const PersistentNode *> pending;
+    const PersistentNode *node = root.get();
+    while (node != nullptr || !pending.empty()) {
+        while (node != nullptr) {
+            pending.push_back(node);
+            node = node->left.get();
+        }
+        node = pending.back();
+        pending.pop_back();
+        node->shape->printShape(writer.text());
+        writer.endLine();
+        node = node->right.get();
+    }
+}
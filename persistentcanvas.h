@@ -0,0 +1,72 @@
+/// @file persistentcanvas.h
+/// @date October 2, 2023
+/// @brief The persistentcanvas file contains declarations for the
+///     PersistentCanvas class, a canvas whose versions share structure.
+///     Shapes sit in an immutable balanced tree ordered by index; an edit
+///     copies only the nodes on one root to leaf path, so any number of
+///     versions can stay alive for undo, redo and history browsing.
+
+#pragma once
+
+#include <memory>
+#include <ostream>
+#include <vector>
+#include "shape.h"
+#include "canvaslist.h"
+
+using namespace std;
+
+struct PersistentNode;
+typedef shared_ptr<const PersistentNode> PersistentLink;
+
+// PersistentNode struct is one node of an AVL tree keyed by index
+// nodes never change once built, so any version may point at them
+struct PersistentNode
+{
+    shared_ptr<Shape> shape;
+    PersistentLink left;
+    PersistentLink right;
+    int size;
+    int height;
+};
+
+// The PersistentCanvas class has the CanvasList operations on one version.
+// Copying a canvas is constant time and gives an independent version;
+// insertAfter, push_front, push_back, removeAt, pop_front, pop_back,
+// replaceAt and shapeAt each take O(log N) and leave other versions as
+// they were. Shapes are shared between versions and must not be changed
+// through shapeAt. Versions may be read from several threads at once.
+class PersistentCanvas
+{
+    private:
+        PersistentLink root;
+
+        static PersistentLink build(const vector<shared_ptr<Shape>> &, int first, int last);
+        static void collect(const PersistentLink &, vector<shared_ptr<Shape>> &);
+
+    public:
+        PersistentCanvas();
+        explicit PersistentCanvas(const CanvasList &);
+
+        void clear();
+
+        void insertAfter(int, Shape *);
+        void push_front(Shape *);
+        void push_back(Shape *);
+        void replaceAt(int, Shape *);
+
+        void removeAt(int);
+        void removeEveryOther();
+        Shape* pop_front();
+        Shape* pop_back();
+
+        bool isempty() const;
+        int size() const;
+        int height() const;
+
+        int find(int x, int y) const;
+        const Shape* shapeAt(int) const;
+
+        void draw() const;
+        void draw(ostream &) const;
+};
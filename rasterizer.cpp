@@ -0,0 +1,57 @@
+// This file contains all the implementation functions used in rasterizer.h
+// It walks each shape's rows and fills the matching spans
+
+#include "rasterizer.h"
+#include <algorithm>
+using namespace std;
+
+// returns the fill color for a shape's type
+uint32_t Rasterizer::colorOf(const Shape &shape) {
+    switch (shape.getType()) {
+        case SHAPE_CIRCLE: return Framebuffer::rgba(230, 60, 50);
+        case SHAPE_RECT: return Framebuffer::rgba(60, 200, 80);
+        case SHAPE_RIGHT_TRIANGLE: return Framebuffer::rgba(50, 90, 230);
+        default: return Framebuffer::rgba(255, 255, 255);
+    }
+}
+
+// fills the part of shape inside clip with color
+// clip must lie inside the framebuffer
+// returns the number of pixels written
+long Rasterizer::drawShape(const Shape &shape, uint32_t color, Framebuffer &target, const Bounds &clip) {
+    Bounds b = shape.getBounds();
+    int firstRow = max(b.minY, clip.minY);
+    int lastRow = min(b.maxY, clip.maxY);
+
+    long written = 0;
+    for (int py = firstRow; py <= lastRow; py++) {
+        int minX;
+        int maxX;
+        if (!shape.rowSpan(py, minX, maxX)) {
+            continue;
+        }
+        minX = max(minX, clip.minX);
+        maxX = min(maxX, clip.maxX);
+        if (minX > maxX) {
+            continue;
+        }
+        target.fillSpan(py, minX, maxX, color);
+        written += maxX - minX + 1;
+    }
+    return written;
+}
+
+// draws every shape in canvas from front to back over the framebuffer
+// returns the number of pixels written
+long Rasterizer::render(const CanvasList &canvas, Framebuffer &target) {
+    if (target.getWidth() == 0 || target.getHeight() == 0) {
+        return 0;
+    }
+    Bounds clip{0, 0, target.getWidth() - 1, target.getHeight() - 1};
+
+    long written = 0;
+    for (ShapeNode *curr = canvas.front(); curr != nullptr; curr = curr->next) {
+        written += drawShape(*curr->value, colorOf(*curr->value), target, clip);
+    }
+    return written;
+}
@@ -0,0 +1,24 @@
+/// @file rasterizer.h
+/// @date October 2, 2023
+/// @brief The rasterizer file contains declarations for the Rasterizer
+///     class that draws a CanvasList into a Framebuffer as real pixels.
+///     Shapes are filled one row span at a time and later shapes in the
+///     list are painted over earlier ones.
+
+#pragma once
+
+#include <cstdint>
+#include "canvaslist.h"
+#include "framebuffer.h"
+#include "shape.h"
+
+// The Rasterizer class fills every pixel that Shape::contains accepts.
+// Shapes are colored by type: Circle red, Rect green, RightTriangle blue
+// and a basic Shape white.
+class Rasterizer
+{
+    public:
+        static uint32_t colorOf(const Shape &);
+        static long drawShape(const Shape &, uint32_t color, Framebuffer &, const Bounds &clip);
+        static long render(const CanvasList &, Framebuffer &);
+};
@@ -3,12 +3,80 @@
 
 // must include in order to use class declarations in shape.h
 #include "shape.h"
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <typeinfo>
 using namespace std;
 
+namespace {
+
+// TextWriter struct fills a caller's buffer for printShape
+// it never writes past the end but keeps counting the full length
+struct TextWriter
+{
+    char *pos;
+    char *end;
+    size_t length;
+
+    TextWriter(char *buffer, size_t capacity) : pos(buffer), end(buffer + capacity), length(0) {}
+
+    void text(const char *data, size_t count) {
+        size_t room = static_cast<size_t>(end - pos);
+        size_t copied = count < room ? count : room;
+        if (copied > 0) {
+            memcpy(pos, data, copied);
+            pos += copied;
+        }
+        length += count;
+    }
+
+    template <size_t N>
+    void text(const char (&literal)[N]) {
+        text(literal, N - 1);
+    }
+
+    // the same digits to_string gives
+    void number(int value) {
+        char digits[16];
+        char *last = to_chars(digits, digits + sizeof(digits), value).ptr;
+        text(digits, last - digits);
+    }
+};
+
+}
+
+// narrows a coordinate worked out in long long, clamping it to the int range
+static int clampToInt(long long value) {
+    return static_cast<int>(clamp<long long>(value, INT_MIN, INT_MAX));
+}
+
 // BASIC SHAPE CLASS STARTS HERE
-Shape::Shape() : x(0), y(0) {}
+Shape::Shape() : observer(nullptr), x(0), y(0) {}
 
-Shape::Shape(int x, int y) : x(x), y(y) {}
+Shape::Shape(int x, int y) : observer(nullptr), x(x), y(y) {}
+
+// copies are never observed, the observer belongs to the original
+Shape::Shape(const Shape &other) : observer(nullptr), x(other.x), y(other.y) {}
+
+// keeps this shape's observer and tells it about the new coordinates
+Shape& Shape::operator=(const Shape &other) {
+    int oldX = x;
+    int oldY = y;
+    assignPosition(other);
+    notifyChanged(oldX, oldY);
+    return *this;
+}
+
+// copies the coordinates without telling the observer
+// derived assignments notify once their own fields are copied too
+void Shape::assignPosition(const Shape &other) {
+    x = other.x;
+    y = other.y;
+}
 
 Shape::~Shape() {}
 
@@ -16,6 +84,10 @@ Shape* Shape::copy() {
     return new Shape(x, y);
 }
 
+ShapeType Shape::getType() const {
+    return SHAPE_BASIC;
+}
+
 int Shape::getX() const{
     return x;
 }
@@ -25,15 +97,105 @@ int Shape::getY() const{
 }
 
 void Shape::setX(int x) {
+    int oldX = this->x;
     this->x = x;
+    notifyChanged(oldX, y);
 }
 
 void Shape::setY(int y) {
+    int oldY = this->y;
     this->y = y;
+    notifyChanged(x, oldY);
+}
+
+ShapeObserver* Shape::getObserver() const {
+    return observer;
+}
+
+void Shape::setObserver(ShapeObserver *observer) {
+    this->observer = observer;
+}
+
+// tells the observer, if any, that this shape changed
+void Shape::notifyChanged(int oldX, int oldY) {
+    if (observer != nullptr) {
+        observer->shapeChanged(this, oldX, oldY);
+    }
+}
+
+// a basic shape is a single point at its origin
+Bounds Shape::getBounds() const {
+    return Bounds{x, y, x, y};
+}
+
+// a point has no area and no perimeter
+double Shape::getArea() const {
+    return 0;
+}
+
+double Shape::getPerimeter() const {
+    return 0;
 }
 
+bool Shape::contains(int px, int py) const {
+    return px == x && py == y;
+}
+
+// finds the pixels of row py that contains() accepts
+// returns false if the row misses the shape
+bool Shape::rowSpan(int py, int &minX, int &maxX) const {
+    if (py != y) {
+        return false;
+    }
+    minX = x;
+    maxX = x;
+    return true;
+}
+
+// builds the description in a new string
+// built on the buffer overload, never on printShape(string &), as that one
+// calls back here for types other than the four in this file
 string Shape::printShape() const {
-    return "It's a Shape at x: " + to_string(x) + ", y: " + to_string(y);
+    char buffer[MAX_TEXT_LENGTH];
+    size_t length = printShape(buffer, MAX_TEXT_LENGTH);
+    return string(buffer, min(length, MAX_TEXT_LENGTH));
+}
+
+// returns true if shape is exactly one of the four types in this file
+// their string form is known to match the buffer overload
+static bool printsDirectly(const Shape &shape) {
+    static const type_info *const builtIn[] = {
+        &typeid(Shape), &typeid(Circle), &typeid(Rect), &typeid(RightTriangle)
+    };
+    return typeid(shape) == *builtIn[shape.getType()];
+}
+
+// appends the description to out and returns its length
+// out only reallocates when it has less than MAX_TEXT_LENGTH spare capacity
+// any other type may override only printShape(), so it is asked for that
+// text instead, which keeps draw printing what printShape() returns
+size_t Shape::printShape(string &out) const {
+    if (!printsDirectly(*this)) {
+        string text = printShape();
+        out += text;
+        return text.size();
+    }
+    size_t start = out.size();
+    out.resize(start + MAX_TEXT_LENGTH);
+    size_t length = printShape(&out[start], MAX_TEXT_LENGTH);
+    out.resize(start + length);
+    return length;
+}
+
+// writes the description into buffer without a terminating null
+// returns the full length, which is more than capacity if it was cut short
+size_t Shape::printShape(char *buffer, size_t capacity) const {
+    TextWriter out(buffer, capacity);
+    out.text("It's a Shape at x: ");
+    out.number(x);
+    out.text(", y: ");
+    out.number(y);
+    return out.length;
 }
 // BASIC SHAPE CLASS ENDS HERE
 
@@ -44,12 +206,27 @@ Rect::Rect(int w, int h) : width(w), height(h) {}
 
 Rect::Rect(int x, int y, int w, int h) : Shape(x, y), width(w), height(h) {}
 
+// notifies only after width and height are copied so indexes see the new size
+Rect& Rect::operator=(const Rect &other) {
+    int oldX = x;
+    int oldY = y;
+    assignPosition(other);
+    width = other.width;
+    height = other.height;
+    notifyChanged(oldX, oldY);
+    return *this;
+}
+
 Rect::~Rect() {}
 
 Rect* Rect::copy() {
     return new Rect(x, y, width, height);
 }
 
+ShapeType Rect::getType() const {
+    return SHAPE_RECT;
+}
+
 int Rect::getWidth() const {
     return width;
 }
@@ -60,14 +237,58 @@ int Rect::getHeight() const {
 
 void Rect::setWidth(int w) {
     width = w;
+    notifyChanged(x, y);
 }
 
 void Rect::setHeight(int h) {
     height = h;
+    notifyChanged(x, y);
 }
 
-string Rect::printShape() const {
-    return "It's a Rectangle at x: " + to_string(x) + ", y: " + to_string(y) + " with width: " + to_string(width) + " and height: " + to_string(height);
+// a rectangle spans width and height from its origin
+// edges past the int range are clamped to it
+Bounds Rect::getBounds() const {
+    long long endX = static_cast<long long>(x) + width;
+    long long endY = static_cast<long long>(y) + height;
+    return Bounds{clampToInt(min<long long>(x, endX)), clampToInt(min<long long>(y, endY)),
+                  clampToInt(max<long long>(x, endX)), clampToInt(max<long long>(y, endY))};
+}
+
+// negative sides mirror the rectangle, so only their lengths count
+double Rect::getArea() const {
+    return fabs(static_cast<double>(width) * height);
+}
+
+double Rect::getPerimeter() const {
+    return 2 * (fabs(static_cast<double>(width)) + fabs(static_cast<double>(height)));
+}
+
+bool Rect::contains(int px, int py) const {
+    Bounds b = getBounds();
+    return px >= b.minX && px <= b.maxX && py >= b.minY && py <= b.maxY;
+}
+
+bool Rect::rowSpan(int py, int &minX, int &maxX) const {
+    Bounds b = getBounds();
+    if (py < b.minY || py > b.maxY) {
+        return false;
+    }
+    minX = b.minX;
+    maxX = b.maxX;
+    return true;
+}
+
+size_t Rect::printShape(char *buffer, size_t capacity) const {
+    TextWriter out(buffer, capacity);
+    out.text("It's a Rectangle at x: ");
+    out.number(x);
+    out.text(", y: ");
+    out.number(y);
+    out.text(" with width: ");
+    out.number(width);
+    out.text(" and height: ");
+    out.number(height);
+    return out.length;
 }
 // RECTANGLE CLASS ENDS HERE
 
@@ -82,22 +303,95 @@ Circle::Circle(int x, int y, int r){
     this->radius = r;
 }
 
+// notifies only after the radius is copied too
+Circle& Circle::operator=(const Circle &other) {
+    int oldX = x;
+    int oldY = y;
+    assignPosition(other);
+    radius = other.radius;
+    notifyChanged(oldX, oldY);
+    return *this;
+}
+
 Circle::~Circle() {}
 
 Circle* Circle::copy() {
     return new Circle(x, y, radius);
 }
 
+ShapeType Circle::getType() const {
+    return SHAPE_CIRCLE;
+}
+
 int Circle::getRadius() const {
     return radius;
 }
 
 void Circle::setRadius(int r) {
     radius = r;
+    notifyChanged(x, y);
+}
+
+// a circle is centered on its origin
+// edges past the int range are clamped to it
+Bounds Circle::getBounds() const {
+    long long r = radius < 0 ? -static_cast<long long>(radius) : radius;
+    return Bounds{clampToInt(x - r), clampToInt(y - r), clampToInt(x + r), clampToInt(y + r)};
+}
+
+double Circle::getArea() const {
+    return numbers::pi * static_cast<double>(radius) * radius;
+}
+
+double Circle::getPerimeter() const {
+    return 2 * numbers::pi * fabs(static_cast<double>(radius));
+}
+
+// every operand is widened before it is used, so far apart points and an
+// INT_MIN radius cannot overflow
+bool Circle::contains(int px, int py) const {
+    long long dx = static_cast<long long>(px) - x;
+    long long dy = static_cast<long long>(py) - y;
+    long long r = radius < 0 ? -static_cast<long long>(radius) : radius;
+    if (dx < -r || dx > r || dy < -r || dy > r) {
+        return false;
+    }
+    // each square is at most 2^62, so their sum still fits unsigned
+    return static_cast<unsigned long long>(dx * dx) + static_cast<unsigned long long>(dy * dy) <=
+           static_cast<unsigned long long>(r * r);
+}
+
+// the span is clamped to the int range
+bool Circle::rowSpan(int py, int &minX, int &maxX) const {
+    long long dy = static_cast<long long>(py) - y;
+    long long r = radius < 0 ? -static_cast<long long>(radius) : radius;
+    if (dy < -r || dy > r) {
+        return false;
+    }
+    long long room = r * r - dy * dy;
+
+    // widest dx with dx * dx <= room, corrected after the floating point guess
+    long long dx = static_cast<long long>(sqrt(static_cast<double>(room)));
+    while (dx * dx > room) {
+        dx--;
+    }
+    while ((dx + 1) * (dx + 1) <= room) {
+        dx++;
+    }
+    minX = clampToInt(x - dx);
+    maxX = clampToInt(x + dx);
+    return true;
 }
 
-string Circle::printShape() const {
-    return "It's a Circle at x: " + to_string(getX()) + ", y: " + to_string(getY()) + ", radius: " + to_string(radius);
+size_t Circle::printShape(char *buffer, size_t capacity) const {
+    TextWriter out(buffer, capacity);
+    out.text("It's a Circle at x: ");
+    out.number(x);
+    out.text(", y: ");
+    out.number(y);
+    out.text(", radius: ");
+    out.number(radius);
+    return out.length;
 }
 // CIRCLE CLASS ENDS HERE
 
@@ -108,12 +402,27 @@ RightTriangle::RightTriangle(int b, int h) : base(b), height(h) {}
 
 RightTriangle::RightTriangle(int x, int y, int b, int h) : Shape(x,y), base(b), height(h) {}
 
+// notifies only after base and height are copied too
+RightTriangle& RightTriangle::operator=(const RightTriangle &other) {
+    int oldX = x;
+    int oldY = y;
+    assignPosition(other);
+    base = other.base;
+    height = other.height;
+    notifyChanged(oldX, oldY);
+    return *this;
+}
+
 RightTriangle::~RightTriangle() {}
 
 RightTriangle* RightTriangle::copy() {
     return new RightTriangle(x, y, base, height);
 }
 
+ShapeType RightTriangle::getType() const {
+    return SHAPE_RIGHT_TRIANGLE;
+}
+
 int RightTriangle::getBase() const {
     return base;
 }
@@ -124,13 +433,83 @@ int RightTriangle::getHeight() const {
 
 void RightTriangle::setBase(int b) {
     base = b;
+    notifyChanged(x, y);
 }
 
 void RightTriangle::setHeight(int h) {
     height = h;
+    notifyChanged(x, y);
+}
+
+// the right angle sits on the origin with the base along x and the height along y
+// clamped to the int range like a rectangle
+Bounds RightTriangle::getBounds() const {
+    long long endX = static_cast<long long>(x) + base;
+    long long endY = static_cast<long long>(y) + height;
+    return Bounds{clampToInt(min<long long>(x, endX)), clampToInt(min<long long>(y, endY)),
+                  clampToInt(max<long long>(x, endX)), clampToInt(max<long long>(y, endY))};
+}
+
+// half the rectangle spanned by base and height
+double RightTriangle::getArea() const {
+    return fabs(static_cast<double>(base) * height) / 2;
+}
+
+// the two legs plus the hypotenuse
+double RightTriangle::getPerimeter() const {
+    double b = fabs(static_cast<double>(base));
+    double h = fabs(static_cast<double>(height));
+    return b + h + sqrt(b * b + h * h);
+}
+
+bool RightTriangle::contains(int px, int py) const {
+    // mirrors the point so base and height can be treated as positive
+    long long u = base < 0 ? static_cast<long long>(x) - px : static_cast<long long>(px) - x;
+    long long v = height < 0 ? static_cast<long long>(y) - py : static_cast<long long>(py) - y;
+    long long b = base < 0 ? -static_cast<long long>(base) : base;
+    long long h = height < 0 ? -static_cast<long long>(height) : height;
+
+    if (u < 0 || v < 0 || u > b || v > h) {
+        return false;
+    }
+    // the point must be on the origin's side of the hypotenuse
+    // each product is at most 2^62, so their sum still fits unsigned
+    return static_cast<unsigned long long>(u * h) + static_cast<unsigned long long>(v * b) <=
+           static_cast<unsigned long long>(b * h);
+}
+
+bool RightTriangle::rowSpan(int py, int &minX, int &maxX) const {
+    // mirrors the row so base and height can be treated as positive
+    long long v = height < 0 ? static_cast<long long>(y) - py : static_cast<long long>(py) - y;
+    long long b = base < 0 ? -static_cast<long long>(base) : base;
+    long long h = height < 0 ? -static_cast<long long>(height) : height;
+    if (v < 0 || v > h) {
+        return false;
+    }
+
+    // widest u on the origin's side of the hypotenuse
+    long long u = h == 0 ? b : b * (h - v) / h;
+    if (base < 0) {
+        minX = clampToInt(x - u);
+        maxX = x;
+    }
+    else {
+        minX = x;
+        maxX = clampToInt(x + u);
+    }
+    return true;
 }
 
-string RightTriangle::printShape() const {
-    return "It's a Right Triangle at x: " + to_string(getX()) + ", y: " + to_string(getY()) + " with base: " + to_string(base) + " and height: " + to_string(height);
+size_t RightTriangle::printShape(char *buffer, size_t capacity) const {
+    TextWriter out(buffer, capacity);
+    out.text("It's a Right Triangle at x: ");
+    out.number(x);
+    out.text(", y: ");
+    out.number(y);
+    out.text(" with base: ");
+    out.number(base);
+    out.text(" and height: ");
+    out.number(height);
+    return out.length;
 }
 // RIGHT TRIANGLE CLASS ENDS HERE
\ No newline at end of file
@@ -12,25 +12,83 @@
 
 using namespace std;
 
+class Shape;
+
+// Bounds struct describes an axis aligned box
+// both corners are inclusive so a point has min equal to max
+struct Bounds
+{
+    int minX;
+    int minY;
+    int maxX;
+    int maxY;
+};
+
+// ShapeType enum names the concrete class of a shape
+// the values are stored in canvas files and must not change
+// the int base keeps out of range values well defined so they can be rejected
+enum ShapeType : int
+{
+    SHAPE_BASIC,
+    SHAPE_CIRCLE,
+    SHAPE_RECT,
+    SHAPE_RIGHT_TRIANGLE
+};
+
+// ShapeObserver class is told whenever an observed shape changes
+// oldX and oldY are the shape's coordinates before the change
+class ShapeObserver
+{
+    public:
+        virtual ~ShapeObserver() {}
+        virtual void shapeChanged(Shape *shape, int oldX, int oldY) = 0;
+};
+
 class Shape
 {
+    private:
+        ShapeObserver *observer;
+
     protected:
         int x;
         int y;
 
+        void notifyChanged(int oldX, int oldY);
+        void assignPosition(const Shape &);
+
     public: 
         Shape();
         Shape(int x, int y);
+        Shape(const Shape &);
+        Shape& operator=(const Shape &);
 
         virtual ~Shape();
         virtual Shape* copy();
+        virtual ShapeType getType() const;
 
         int getX() const;
         int getY() const;
         void setX(int);
         void setY(int);
+
+        ShapeObserver* getObserver() const;
+        void setObserver(ShapeObserver *);
+
+        virtual Bounds getBounds() const;
+        virtual double getArea() const;
+        virtual double getPerimeter() const;
+        virtual bool contains(int px, int py) const;
+        virtual bool rowSpan(int py, int &minX, int &maxX) const;
         
+        // printShape(buffer, capacity) is the one each type overrides and
+        // the other two forms are built on it; draw appends through
+        // printShape(out), which reaches an override of printShape() too
         virtual string printShape() const;
+        virtual size_t printShape(string &out) const;
+        virtual size_t printShape(char *buffer, size_t capacity) const;
+
+        // longest text any printShape can produce
+        static constexpr size_t MAX_TEXT_LENGTH = 128;
 };
 
 
@@ -43,14 +101,24 @@ class Circle : public Shape
         Circle();
         Circle(int r);
         Circle(int x, int y, int r);
+        Circle(const Circle &) = default;
+        Circle& operator=(const Circle &);
 
         virtual ~Circle();
         virtual Circle* copy();
+        virtual ShapeType getType() const;
         
         int getRadius() const;
         void setRadius(int);
+
+        virtual Bounds getBounds() const;
+        virtual double getArea() const;
+        virtual double getPerimeter() const;
+        virtual bool contains(int px, int py) const;
+        virtual bool rowSpan(int py, int &minX, int &maxX) const;
         
-        virtual string printShape() const;
+        using Shape::printShape;
+        virtual size_t printShape(char *buffer, size_t capacity) const;
 };
 
 
@@ -64,16 +132,26 @@ class Rect : public Shape
         Rect();
         Rect(int w, int h);
         Rect(int x, int y, int w, int h);
+        Rect(const Rect &) = default;
+        Rect& operator=(const Rect &);
         
         virtual ~Rect();
         virtual Rect* copy();
+        virtual ShapeType getType() const;
         
         int getWidth() const;
         int getHeight() const;
         void setWidth(int);
         void setHeight(int);
+
+        virtual Bounds getBounds() const;
+        virtual double getArea() const;
+        virtual double getPerimeter() const;
+        virtual bool contains(int px, int py) const;
+        virtual bool rowSpan(int py, int &minX, int &maxX) const;
         
-        virtual string printShape() const;
+        using Shape::printShape;
+        virtual size_t printShape(char *buffer, size_t capacity) const;
 };
 
 class RightTriangle : public Shape 
@@ -86,14 +164,24 @@ class RightTriangle : public Shape
         RightTriangle();
         RightTriangle(int b, int h);
         RightTriangle(int x, int y, int b, int h);
+        RightTriangle(const RightTriangle &) = default;
+        RightTriangle& operator=(const RightTriangle &);
         
         virtual ~RightTriangle();
         virtual RightTriangle* copy();
+        virtual ShapeType getType() const;
         
         int getBase() const;
         int getHeight() const;
         void setBase(int);
         void setHeight(int);
 
-        virtual string printShape() const;
+        virtual Bounds getBounds() const;
+        virtual double getArea() const;
+        virtual double getPerimeter() const;
+        virtual bool contains(int px, int py) const;
+        virtual bool rowSpan(int py, int &minX, int &maxX) const;
+
+        using Shape::printShape;
+        virtual size_t printShape(char *buffer, size_t capacity) const;
 };
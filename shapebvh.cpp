@@ -0,0 +1,238 @@
+// This file contains all the implementation functions used in shapebvh.h
+// It bulk loads the tree and answers point, window and nearest queries
+
+#include "shapebvh.h"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+using namespace std;
+
+// returns twice the center of a box so no precision is lost
+static long long centerX(const Bounds &b) {
+    return (long long)b.minX + b.maxX;
+}
+
+static long long centerY(const Bounds &b) {
+    return (long long)b.minY + b.maxY;
+}
+
+// checks if two boxes share at least one point
+static bool overlaps(const Bounds &a, const Bounds &b) {
+    return a.maxX >= b.minX && a.minX <= b.maxX && a.maxY >= b.minY && a.minY <= b.maxY;
+}
+
+// Default constructor : initializes an empty tree
+ShapeBVH::ShapeBVH() : root(-1) {}
+
+// Snapshot constructor : builds the tree over every shape in canvas
+ShapeBVH::ShapeBVH(const CanvasList &canvas) : root(-1) {
+    build(canvas);
+}
+
+// returns the smallest box holding both boxes
+Bounds ShapeBVH::merge(const Bounds &a, const Bounds &b) {
+    return Bounds{min(a.minX, b.minX), min(a.minY, b.minY), max(a.maxX, b.maxX), max(a.maxY, b.maxY)};
+}
+
+// returns the squared distance from px,py to the nearest point of a box
+// returns 0 if the point is inside the box
+long long ShapeBVH::distanceSquared(const Bounds &b, int px, int py) {
+    long long dx = px < b.minX ? (long long)b.minX - px : (px > b.maxX ? (long long)px - b.maxX : 0);
+    long long dy = py < b.minY ? (long long)b.minY - py : (py > b.maxY ? (long long)py - b.maxY : 0);
+    return dx * dx + dy * dy;
+}
+
+// orders boxes for Sort-Tile-Recursive packing
+// sorts by center x, cuts into vertical slices, then sorts each slice by center y
+template <class T>
+void ShapeBVH::strSort(vector<T> &boxes) {
+    size_t groups = (boxes.size() + NODE_CAPACITY - 1) / NODE_CAPACITY;
+    size_t slices = static_cast<size_t>(ceil(sqrt(static_cast<double>(groups))));
+    size_t sliceSize = slices * NODE_CAPACITY;
+
+    sort(boxes.begin(), boxes.end(), [](const T &a, const T &b) {
+        return centerX(a.bounds) < centerX(b.bounds);
+    });
+    for (size_t start = 0; start < boxes.size(); start += sliceSize) {
+        size_t end = min(boxes.size(), start + sliceSize);
+        sort(boxes.begin() + start, boxes.begin() + end, [](const T &a, const T &b) {
+            return centerY(a.bounds) < centerY(b.bounds);
+        });
+    }
+}
+
+// throws away the old tree and packs a new one over canvas
+void ShapeBVH::build(const CanvasList &canvas) {
+    items.clear();
+    nodes.clear();
+    root = -1;
+
+    items.reserve(canvas.size());
+    int index = 0;
+    for (ShapeNode *curr = canvas.front(); curr != nullptr; curr = curr->next) {
+        items.push_back(Item{curr->value->getBounds(), curr->value, index});
+        index++;
+    }
+    if (items.empty()) {
+        return;
+    }
+
+    // packs items into leaves
+    strSort(items);
+    vector<Node> level;
+    for (size_t first = 0; first < items.size(); first += NODE_CAPACITY) {
+        Node leaf{items[first].bounds, static_cast<int>(first), 0, true};
+        for (size_t i = first; i < items.size() && i < first + NODE_CAPACITY; i++) {
+            leaf.bounds = merge(leaf.bounds, items[i].bounds);
+            leaf.count++;
+        }
+        level.push_back(leaf);
+    }
+
+    // packs each level into parents until one node is left
+    while (level.size() > 1) {
+        strSort(level);
+        int base = static_cast<int>(nodes.size());
+        nodes.insert(nodes.end(), level.begin(), level.end());
+
+        vector<Node> parents;
+        for (size_t first = 0; first < level.size(); first += NODE_CAPACITY) {
+            Node parent{level[first].bounds, base + static_cast<int>(first), 0, false};
+            for (size_t i = first; i < level.size() && i < first + NODE_CAPACITY; i++) {
+                parent.bounds = merge(parent.bounds, level[i].bounds);
+                parent.count++;
+            }
+            parents.push_back(parent);
+        }
+        level.swap(parents);
+    }
+
+    nodes.push_back(level[0]);
+    root = static_cast<int>(nodes.size()) - 1;
+}
+
+// returns the indexes of every shape covering px,py in ascending order
+vector<int> ShapeBVH::queryPoint(int px, int py) const {
+    vector<int> found;
+    if (root < 0) {
+        return found;
+    }
+
+    Bounds point{px, py, px, py};
+    vector<int> stack{root};
+    while (!stack.empty()) {
+        const Node &node = nodes[stack.back()];
+        stack.pop_back();
+        if (!overlaps(node.bounds, point)) {
+            continue;
+        }
+        for (int i = node.first; i < node.first + node.count; i++) {
+            if (!node.leaf) {
+                stack.push_back(i);
+            }
+            else if (overlaps(items[i].bounds, point) && items[i].shape->contains(px, py)) {
+                found.push_back(items[i].index);
+            }
+        }
+    }
+    sort(found.begin(), found.end());
+    return found;
+}
+
+// returns the indexes of every shape whose bounds overlap area in ascending order
+vector<int> ShapeBVH::queryWindow(const Bounds &area) const {
+    vector<int> found;
+    if (root < 0) {
+        return found;
+    }
+
+    vector<int> stack{root};
+    while (!stack.empty()) {
+        const Node &node = nodes[stack.back()];
+        stack.pop_back();
+        if (!overlaps(node.bounds, area)) {
+            continue;
+        }
+        for (int i = node.first; i < node.first + node.count; i++) {
+            if (!node.leaf) {
+                stack.push_back(i);
+            }
+            else if (overlaps(items[i].bounds, area)) {
+                found.push_back(items[i].index);
+            }
+        }
+    }
+    sort(found.begin(), found.end());
+    return found;
+}
+
+// returns the indexes of the k shapes whose bounds are closest to px,py
+// closest first, ties go to the lower index
+vector<int> ShapeBVH::nearest(int px, int py, int k) const {
+    vector<int> found;
+    if (root < 0 || k <= 0) {
+        return found;
+    }
+
+    // best first search where a candidate is a tree node, or a shape when node < 0
+    struct Candidate
+    {
+        long long distance;
+        int index;
+        int node;
+        bool operator>(const Candidate &other) const {
+            if (distance != other.distance) {
+                return distance > other.distance;
+            }
+            // nodes come out before shapes at the same distance, as a node
+            // at that distance may still hold a lower index
+            if ((node < 0) != (other.node < 0)) {
+                return node < 0;
+            }
+            return index > other.index;
+        }
+    };
+    priority_queue<Candidate, vector<Candidate>, greater<Candidate>> queue;
+    queue.push(Candidate{distanceSquared(nodes[root].bounds, px, py), -1, root});
+
+    while (!queue.empty() && static_cast<int>(found.size()) < k) {
+        Candidate best = queue.top();
+        queue.pop();
+
+        if (best.node < 0) {
+            found.push_back(best.index);
+            continue;
+        }
+
+        const Node &node = nodes[best.node];
+        for (int i = node.first; i < node.first + node.count; i++) {
+            if (node.leaf) {
+                queue.push(Candidate{distanceSquared(items[i].bounds, px, py), items[i].index, -1});
+            }
+            else {
+                queue.push(Candidate{distanceSquared(nodes[i].bounds, px, py), -1, i});
+            }
+        }
+    }
+    return found;
+}
+
+// returns the number of shapes in the tree
+int ShapeBVH::size() const {
+    return static_cast<int>(items.size());
+}
+
+// returns the number of levels in the tree
+// returns 0 if the tree is empty
+int ShapeBVH::height() const {
+    if (root < 0) {
+        return 0;
+    }
+    int levels = 1;
+    int curr = root;
+    while (!nodes[curr].leaf) {
+        curr = nodes[curr].first;
+        levels++;
+    }
+    return levels;
+}
@@ -0,0 +1,63 @@
+/// @file shapebvh.h
+/// @date October 2, 2023
+/// @brief The shapebvh file contains declarations for the ShapeBVH class,
+///     a bounding volume hierarchy bulk loaded from a snapshot of a
+///     CanvasList. It suits canvases that are loaded once and queried
+///     many times, including ones whose shapes vary wildly in size.
+
+#pragma once
+
+#include <vector>
+#include "shape.h"
+#include "canvaslist.h"
+
+using namespace std;
+
+// The ShapeBVH class packs the bounding boxes of every shape in a canvas
+// into a tree using Sort-Tile-Recursive loading. It keeps pointers to the
+// canvas's shapes and does not follow later changes to the canvas, so it
+// must be rebuilt after the canvas is edited.
+class ShapeBVH
+{
+    private:
+        struct Item
+        {
+            Bounds bounds;
+            const Shape *shape;
+            int index;
+        };
+
+        // a leaf covers items [first, first + count), any other node
+        // covers child nodes [first, first + count)
+        struct Node
+        {
+            Bounds bounds;
+            int first;
+            int count;
+            bool leaf;
+        };
+
+        vector<Item> items;
+        vector<Node> nodes;
+        int root;
+
+        template <class T>
+        static void strSort(vector<T> &);
+        static Bounds merge(const Bounds &, const Bounds &);
+        static long long distanceSquared(const Bounds &, int px, int py);
+
+    public:
+        static constexpr int NODE_CAPACITY = 8;
+
+        ShapeBVH();
+        explicit ShapeBVH(const CanvasList &);
+
+        void build(const CanvasList &);
+
+        vector<int> queryPoint(int px, int py) const;
+        vector<int> queryWindow(const Bounds &area) const;
+        vector<int> nearest(int px, int py, int k) const;
+
+        int size() const;
+        int height() const;
+};
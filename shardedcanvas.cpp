@@ -0,0 +1,181 @@
+// This file contains all the implementation functions used in shardedcanvas.h
+// Whole-canvas functions lock one shard at a time, inside that shard's task
+
+#include "shardedcanvas.h"
+#include <cstdint>
+#include <iostream>
+#include <string>
+using namespace std;
+
+// rounds a coordinate down to the cell holding it
+static int cellOf(int value, int cellSize) {
+    int cell = value / cellSize;
+    return (value % cellSize < 0) ? cell - 1 : cell;
+}
+
+// Parameter constructor : creates shardCount empty shards
+// a cellSize of 0 or less routes by exact point
+ShardedCanvas::ShardedCanvas(ThreadPool &pool, int shardCount, int cellSize)
+    : pool(pool), cellSize(cellSize > 0 ? cellSize : 0) {
+    if (shardCount < 1) {
+        shardCount = 1;
+    }
+    for (int i = 0; i < shardCount; i++) {
+        shards.push_back(make_unique<Shard>());
+    }
+}
+
+// returns the shard a shape at (x, y) belongs in
+int ShardedCanvas::shardOf(int x, int y) const {
+    if (cellSize > 0) {
+        x = cellOf(x, cellSize);
+        y = cellOf(y, cellSize);
+    }
+    // mixes both coordinates so rows and columns spread over every shard
+    uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return static_cast<int>(key % shards.size());
+}
+
+// returns the number of shards
+int ShardedCanvas::shardCount() const {
+    return static_cast<int>(shards.size());
+}
+
+// returns the number of shapes in each shard
+vector<int> ShardedCanvas::shardSizes() const {
+    vector<int> sizes;
+    for (const unique_ptr<Shard> &shard : shards) {
+        lock_guard<mutex> lock(shard->lock);
+        sizes.push_back(shard->list.size());
+    }
+    return sizes;
+}
+
+// turns on the hash index for find in every shard
+void ShardedCanvas::enableFindIndex() {
+    for (unique_ptr<Shard> &shard : shards) {
+        lock_guard<mutex> lock(shard->lock);
+        shard->list.enableFindIndex();
+    }
+}
+
+// removes and deletes every shape
+void ShardedCanvas::clear() {
+    for (unique_ptr<Shard> &shard : shards) {
+        lock_guard<mutex> lock(shard->lock);
+        shard->list.clear();
+    }
+}
+
+// adds shape to the back of its shard, the canvas takes ownership of it
+void ShardedCanvas::push_back(Shape *shape) {
+    Shard &shard = *shards[shardOf(shape->getX(), shape->getY())];
+    lock_guard<mutex> lock(shard.lock);
+    shard.list.push_back(shape);
+}
+
+// removes and deletes the shape ref names
+// does nothing if ref is out of range
+void ShardedCanvas::removeAt(ShardRef ref) {
+    if (ref.shard < 0 || ref.shard >= shardCount()) {
+        return;
+    }
+    Shard &shard = *shards[ref.shard];
+    lock_guard<mutex> lock(shard.lock);
+    shard.list.removeAt(ref.index);
+}
+
+// returns true if every shard is empty and false if one is not
+bool ShardedCanvas::isempty() const {
+    return size() == 0;
+}
+
+// returns number of shapes over all shards
+int ShardedCanvas::size() const {
+    int total = 0;
+    for (int shardSize : shardSizes()) {
+        total += shardSize;
+    }
+    return total;
+}
+
+// finds the first shape added at the given point
+// only the shard the point maps to is searched
+ShardRef ShardedCanvas::find(int x, int y) const {
+    int idx = shardOf(x, y);
+    const Shard &shard = *shards[idx];
+    lock_guard<mutex> lock(shard.lock);
+    int found = shard.list.find(x, y);
+    return found < 0 ? ShardRef{-1, -1} : ShardRef{idx, found};
+}
+
+// calls reader with the shape ref names while holding its shard's lock,
+// so no other thread can remove it until reader returns
+// returns false without calling reader if ref is out of range
+bool ShardedCanvas::withShape(ShardRef ref, const function<void(const Shape &)> &reader) const {
+    if (ref.shard < 0 || ref.shard >= shardCount()) {
+        return false;
+    }
+    const Shard &shard = *shards[ref.shard];
+    lock_guard<mutex> lock(shard.lock);
+    const Shape *shape = shard.list.shapeAt(ref.index);
+    if (shape == nullptr) {
+        return false;
+    }
+    reader(*shape);
+    return true;
+}
+
+// counts the shapes matching test, one shard per task
+long ShardedCanvas::countIf(const function<bool(const Shape &)> &test) const {
+    vector<long> counts(shards.size(), 0);
+    forEachShard([&](int idx, const CanvasList &list) {
+        for (ShapeNode *curr = list.front(); curr != nullptr; curr = curr->next) {
+            if (test(*curr->value)) {
+                counts[idx]++;
+            }
+        }
+    });
+    long total = 0;
+    for (long count : counts) {
+        total += count;
+    }
+    return total;
+}
+
+// runs task once per shard on the pool, holding that shard's lock
+// returns once every shard is done
+// task must not run anything on the same pool, such as a CanvasSearch
+// built on it, as ThreadPool::run would wait for itself forever
+void ShardedCanvas::forEachShard(const function<void(int, const CanvasList &)> &task) const {
+    pool.run(shardCount(), [&](int idx) {
+        const Shard &shard = *shards[idx];
+        lock_guard<mutex> lock(shard.lock);
+        task(idx, shard.list);
+    });
+}
+
+// draws all shapes to standard output
+void ShardedCanvas::draw() const {
+    draw(cout);
+    cout.flush();
+}
+
+// draws all shapes to out, shard after shard
+// each shard's text is built on its own task, then written in order
+void ShardedCanvas::draw(ostream &out) const {
+    vector<string> texts(shards.size());
+    forEachShard([&](int idx, const CanvasList &list) {
+        texts[idx].reserve(static_cast<size_t>(list.size()) * 48);
+        for (ShapeNode *curr = list.front(); curr != nullptr; curr = curr->next) {
+            curr->value->printShape(texts[idx]);
+            texts[idx] += '\n';
+        }
+    });
+    for (const string &text : texts) {
+        out.write(text.data(), text.size());
+    }
+}
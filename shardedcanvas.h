@@ -0,0 +1,74 @@
+/// @file shardedcanvas.h
+/// @date October 2, 2023
+/// @brief The shardedcanvas file contains declarations for the
+///     ShardedCanvas class that splits shapes across independent
+///     CanvasList shards by their coordinates. Each shard has its own
+///     lock, find only visits the shard a point maps to, and whole-canvas
+///     work runs one shard per task on a ThreadPool.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+#include "shape.h"
+#include "canvaslist.h"
+#include "threadpool.h"
+
+using namespace std;
+
+// ShardRef struct names one shape as a shard and an index inside it
+// both are -1 when nothing was found
+struct ShardRef
+{
+    int shard;
+    int index;
+};
+
+// The ShardedCanvas class routes each shape by its (x, y): with a cell
+// size of 0 by the exact point, otherwise by the cellSize square holding
+// it, so nearby shapes share a shard. Shapes with the same point always
+// share a shard, in the order they were added. Threads working on
+// different shards never wait for each other. Shapes are read-only once
+// added because moving one could change the shard it belongs to.
+class ShardedCanvas
+{
+    private:
+        // Shard struct is one independent sub-canvas
+        struct Shard
+        {
+            CanvasList list;
+            mutable mutex lock;
+        };
+
+        ThreadPool &pool;
+        int cellSize;
+        vector<unique_ptr<Shard>> shards;
+
+    public:
+        ShardedCanvas(ThreadPool &pool, int shardCount, int cellSize = 0);
+        ShardedCanvas(const ShardedCanvas &) = delete;
+        ShardedCanvas& operator=(const ShardedCanvas &) = delete;
+
+        int shardOf(int x, int y) const;
+        int shardCount() const;
+        vector<int> shardSizes() const;
+        void enableFindIndex();
+
+        void clear();
+        void push_back(Shape *);
+        void removeAt(ShardRef);
+
+        bool isempty() const;
+        int size() const;
+
+        ShardRef find(int x, int y) const;
+        bool withShape(ShardRef, const function<void(const Shape &)> &) const;
+        long countIf(const function<bool(const Shape &)> &) const;
+        void forEachShard(const function<void(int, const CanvasList &)> &) const;
+
+        void draw() const;
+        void draw(ostream &) const;
+};
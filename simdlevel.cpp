@@ -0,0 +1,45 @@
+// This file contains all the implementation functions used in simdlevel.h
+
+#include "simdlevel.h"
+#include <atomic>
+using namespace std;
+
+// the cap set by limit(), AVX2 means no cap
+static atomic<int> levelCap(SIMD_AVX2);
+
+// returns the best kernel flavour the CPU supports
+SimdKind SimdLevel::detected() {
+    static const SimdKind best = [] {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return SIMD_AVX2;
+        }
+        if (__builtin_cpu_supports("sse4.1")) {
+            return SIMD_SSE41;
+        }
+#endif
+        return SIMD_SCALAR;
+    }();
+    return best;
+}
+
+// returns the flavour kernels should use now
+SimdKind SimdLevel::active() {
+    int cap = levelCap.load(memory_order_relaxed);
+    return detected() < cap ? detected() : static_cast<SimdKind>(cap);
+}
+
+// caps the flavour kernels may use, SIMD_AVX2 removes the cap
+void SimdLevel::limit(SimdKind kind) {
+    levelCap.store(kind, memory_order_relaxed);
+}
+
+// returns a printable name for kind
+const char* SimdLevel::name(SimdKind kind) {
+    switch (kind) {
+        case SIMD_AVX2: return "avx2";
+        case SIMD_SSE41: return "sse4.1";
+        default: return "scalar";
+    }
+}
@@ -0,0 +1,26 @@
+/// @file simdlevel.h
+/// @date October 2, 2023
+/// @brief The simdlevel file contains declarations for the SimdLevel
+///     class that picks which instruction set the bulk kernels use.
+///     The CPU is checked once at run time so one binary runs everywhere.
+
+#pragma once
+
+// SimdKind enum names the kernel flavours, from slowest to fastest
+enum SimdKind
+{
+    SIMD_SCALAR,
+    SIMD_SSE41,
+    SIMD_AVX2
+};
+
+// The SimdLevel class reports the best kernel flavour this CPU supports.
+// limit() caps it, which lets tests and benchmarks compare every flavour.
+class SimdLevel
+{
+    public:
+        static SimdKind detected();
+        static SimdKind active();
+        static void limit(SimdKind);
+        static const char* name(SimdKind);
+};
@@ -0,0 +1,198 @@
+// This file contains all the implementation functions used in spatialgrid.h
+// It files nodes under the grid cells covered by their shape's bounds
+
+#include "spatialgrid.h"
+#include "canvaslist.h"
+#include <algorithm>
+using namespace std;
+
+// mixes the packed cell coordinates so neighbouring cells spread out
+size_t SpatialGrid::KeyHash::operator()(unsigned long long key) const {
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return static_cast<size_t>(key);
+}
+
+// packs both cell coordinates into one 64 bit key
+unsigned long long SpatialGrid::key(int cellX, int cellY) {
+    return (static_cast<unsigned long long>(static_cast<unsigned int>(cellX)) << 32) | static_cast<unsigned int>(cellY);
+}
+
+// Parameter constructor : initializes an empty grid with square cells
+// cells smaller than 1 unit are widened to 1
+SpatialGrid::SpatialGrid(int cellSize) : cellSize(cellSize < 1 ? 1 : cellSize) {}
+
+// returns the cell a coordinate falls in, rounding toward negative infinity
+int SpatialGrid::cellOf(int coordinate) const {
+    return coordinate >= 0 ? coordinate / cellSize : -((-(long long)coordinate + cellSize - 1) / cellSize);
+}
+
+// removes node from a cell or from the large list
+void SpatialGrid::erase(vector<Entry> &nodes, ShapeNode *node) {
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (nodes[i].node == node) {
+            // order inside a cell does not matter so swap with the last
+            nodes[i] = nodes.back();
+            nodes.pop_back();
+            return;
+        }
+    }
+}
+
+// adds the entry's node to every cell its bounds touch
+void SpatialGrid::file(const Entry &entry) {
+    if (entry.large) {
+        largeNodes.push_back(entry);
+        return;
+    }
+    for (int cx = cellOf(entry.bounds.minX); cx <= cellOf(entry.bounds.maxX); cx++) {
+        for (int cy = cellOf(entry.bounds.minY); cy <= cellOf(entry.bounds.maxY); cy++) {
+            cells[key(cx, cy)].push_back(entry);
+        }
+    }
+}
+
+// removes the entry's node from every cell it was filed under
+void SpatialGrid::unfile(const Entry &entry) {
+    if (entry.large) {
+        erase(largeNodes, entry.node);
+        return;
+    }
+    for (int cx = cellOf(entry.bounds.minX); cx <= cellOf(entry.bounds.maxX); cx++) {
+        for (int cy = cellOf(entry.bounds.minY); cy <= cellOf(entry.bounds.maxY); cy++) {
+            auto it = cells.find(key(cx, cy));
+            if (it != cells.end()) {
+                erase(it->second, entry.node);
+                if (it->second.empty()) {
+                    cells.erase(it);
+                }
+            }
+        }
+    }
+}
+
+// adds node under the current bounds of its shape
+void SpatialGrid::insert(ShapeNode *node) {
+    Entry entry;
+    entry.node = node;
+    entry.bounds = node->value->getBounds();
+
+    long long spanX = (long long)cellOf(entry.bounds.maxX) - cellOf(entry.bounds.minX) + 1;
+    long long spanY = (long long)cellOf(entry.bounds.maxY) - cellOf(entry.bounds.minY) + 1;
+    entry.large = spanX * spanY > MAX_CELLS_PER_SHAPE;
+
+    entries[node->value] = entry;
+    file(entry);
+}
+
+// removes node from the grid
+void SpatialGrid::remove(ShapeNode *node) {
+    auto it = entries.find(node->value);
+    if (it == entries.end()) {
+        return;
+    }
+    unfile(it->second);
+    entries.erase(it);
+}
+
+// refiles the node holding shape after its position or size changed
+void SpatialGrid::update(const Shape *shape) {
+    auto it = entries.find(shape);
+    if (it == entries.end()) {
+        return;
+    }
+    ShapeNode *node = it->second.node;
+    unfile(it->second);
+    entries.erase(it);
+    insert(node);
+}
+
+// removes every node from the grid
+void SpatialGrid::clear() {
+    cells.clear();
+    largeNodes.clear();
+    entries.clear();
+}
+
+// appends every node whose shape covers px,py
+// nodes come out in no particular order
+void SpatialGrid::queryPoint(int px, int py, vector<ShapeNode *> &out) const {
+    auto it = cells.find(key(cellOf(px), cellOf(py)));
+    if (it != cells.end()) {
+        for (const Entry &entry : it->second) {
+            if (entry.node->value->contains(px, py)) {
+                out.push_back(entry.node);
+            }
+        }
+    }
+    for (const Entry &entry : largeNodes) {
+        if (entry.node->value->contains(px, py)) {
+            out.push_back(entry.node);
+        }
+    }
+}
+
+// appends the nodes filed under one cell whose bounds overlap area
+void SpatialGrid::collectCell(int cellX, int cellY, const vector<Entry> &cell, const Bounds &area, vector<ShapeNode *> &out) const {
+    for (const Entry &entry : cell) {
+        const Bounds &b = entry.bounds;
+        if (b.maxX < area.minX || b.minX > area.maxX || b.maxY < area.minY || b.minY > area.maxY) {
+            continue;
+        }
+        // a node filed under several cells is only reported from the
+        // cell holding the top left corner of the overlap
+        if (cellOf(max(b.minX, area.minX)) == cellX && cellOf(max(b.minY, area.minY)) == cellY) {
+            out.push_back(entry.node);
+        }
+    }
+}
+
+// appends every node whose shape's bounds overlap area
+// nodes come out in no particular order
+void SpatialGrid::queryRect(const Bounds &area, vector<ShapeNode *> &out) const {
+    int firstX = cellOf(area.minX);
+    int firstY = cellOf(area.minY);
+    int lastX = cellOf(area.maxX);
+    int lastY = cellOf(area.maxY);
+
+    long long span = ((long long)lastX - firstX + 1) * ((long long)lastY - firstY + 1);
+    if (span <= (long long)cells.size()) {
+        // visits every cell the area covers
+        for (int cx = firstX; cx <= lastX; cx++) {
+            for (int cy = firstY; cy <= lastY; cy++) {
+                auto it = cells.find(key(cx, cy));
+                if (it != cells.end()) {
+                    collectCell(cx, cy, it->second, area, out);
+                }
+            }
+        }
+    }
+    else {
+        // the area covers more cells than are in use so visits the used ones
+        for (const auto &cell : cells) {
+            int cx = static_cast<int>(cell.first >> 32);
+            int cy = static_cast<int>(cell.first & 0xffffffffULL);
+            if (cx >= firstX && cx <= lastX && cy >= firstY && cy <= lastY) {
+                collectCell(cx, cy, cell.second, area, out);
+            }
+        }
+    }
+
+    for (const Entry &entry : largeNodes) {
+        const Bounds &b = entry.bounds;
+        if (!(b.maxX < area.minX || b.minX > area.maxX || b.maxY < area.minY || b.minY > area.maxY)) {
+            out.push_back(entry.node);
+        }
+    }
+}
+
+// returns the side length of a cell
+int SpatialGrid::getCellSize() const {
+    return cellSize;
+}
+
+// returns the number of nodes in the grid
+int SpatialGrid::size() const {
+    return static_cast<int>(entries.size());
+}
@@ -0,0 +1,65 @@
+/// @file spatialgrid.h
+/// @date October 2, 2023
+/// @brief The spatialgrid file contains declarations for the SpatialGrid
+///     class, a uniform grid over the bounding boxes of the shapes in a
+///     CanvasList. CanvasList keeps it up to date and uses it to answer
+///     which shapes cover a point or overlap a rectangle without looking
+///     at every shape.
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "shape.h"
+
+using namespace std;
+
+class ShapeNode;
+
+// The SpatialGrid class files every node under each square cell that its
+// shape's bounding box touches. Shapes that would touch too many cells
+// are kept on a separate list that every query checks.
+class SpatialGrid
+{
+    private:
+        struct KeyHash
+        {
+            size_t operator()(unsigned long long key) const;
+        };
+
+        // where a node was filed, so it can be found again after its shape changed
+        struct Entry
+        {
+            ShapeNode *node;
+            Bounds bounds;
+            bool large;
+        };
+
+        int cellSize;
+        unordered_map<unsigned long long, vector<Entry>, KeyHash> cells;
+        vector<Entry> largeNodes;
+        unordered_map<const Shape *, Entry> entries;
+
+        int cellOf(int coordinate) const;
+        static unsigned long long key(int cellX, int cellY);
+        static void erase(vector<Entry> &, ShapeNode *);
+        void file(const Entry &);
+        void unfile(const Entry &);
+        void collectCell(int cellX, int cellY, const vector<Entry> &, const Bounds &, vector<ShapeNode *> &) const;
+
+    public:
+        static constexpr int MAX_CELLS_PER_SHAPE = 64;
+
+        explicit SpatialGrid(int cellSize);
+
+        void insert(ShapeNode *);
+        void remove(ShapeNode *);
+        void update(const Shape *);
+        void clear();
+
+        void queryPoint(int px, int py, vector<ShapeNode *> &out) const;
+        void queryRect(const Bounds &area, vector<ShapeNode *> &out) const;
+
+        int getCellSize() const;
+        int size() const;
+};
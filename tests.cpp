@@ -13,8 +13,35 @@
 #define CATCH_CONFIG_MAIN
 
 #include "catch.hpp"
+#include <atomic>
+#include <climits>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
 #include "shape.h"
 #include "canvaslist.h"
+#include "canvasvector.h"
+#include "bulktransform.h"
+#include "canvasfile.h"
+#include "canvasparser.h"
+#include "canvassearch.h"
+#include "canvasstats.h"
+#include "canvasview.h"
+#include "columncanvas.h"
+#include "concurrentcanvas.h"
+#include "cowcanvas.h"
+#include "persistentcanvas.h"
+#include "shapebvh.h"
+#include "shardedcanvas.h"
+#include "simdlevel.h"
+#include "framebuffer.h"
+#include "ingeststack.h"
+#include "rasterizer.h"
+#include "threadpool.h"
+#include "tilerenderer.h"
+#include "valuecanvas.h"
 
 using namespace std;
 
@@ -748,4 +775,2299 @@ TEST_CASE("Combined Output 3") {
     
     myCanvas.clear();
     REQUIRE(myCanvas.size() == 0);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Doubly Linked Canvas List") {
+  SECTION("back Function") {
+    CanvasList canvas;
+
+    // makes sure an empty canvas has no back node
+    REQUIRE(canvas.back() == nullptr);
+
+    Shape *a = new Shape(1, 1);
+    Shape *b = new Circle(2, 2, 2);
+    Shape *c = new Rect(3, 3, 3, 3);
+
+    // makes sure the back node follows push_back, push_front and insertAfter
+    canvas.push_back(a);
+    REQUIRE(canvas.back()->value == a);
+    canvas.push_front(b);
+    REQUIRE(canvas.back()->value == a);
+    canvas.insertAfter(1, c);
+    REQUIRE(canvas.back()->value == c);
+    REQUIRE(canvas.shapeAt(2) == c);
+
+    // makes sure the back node is fixed up after removals
+    canvas.removeAt(2);
+    REQUIRE(canvas.back()->value == a);
+    REQUIRE(canvas.pop_back() == a);
+    REQUIRE(canvas.back()->value == b);
+    REQUIRE(canvas.pop_back() == b);
+    REQUIRE(canvas.back() == nullptr);
+    REQUIRE(canvas.front() == nullptr);
+
+    delete a;
+    delete b;
+  }
+
+  SECTION("Back Links") {
+    CanvasList canvas;
+    for (int i = 0; i < 7; i++) {
+      canvas.push_back(new Shape(i, i));
+    }
+    canvas.removeEveryOther();
+    canvas.insertAfter(0, new Shape(9, 9));
+
+    // walks the list backwards and makes sure it mirrors the forward order
+    int idx = canvas.size() - 1;
+    for (ShapeNode *curr = canvas.back(); curr != nullptr; curr = curr->prev) {
+      REQUIRE(curr->value == canvas.shapeAt(idx));
+      if (curr->next != nullptr) {
+        REQUIRE(curr->next->prev == curr);
+      }
+      idx--;
+    }
+    REQUIRE(idx == -1);
+    REQUIRE(canvas.front()->prev == nullptr);
+  }
+
+  SECTION("Copy Keeps Order") {
+    CanvasList original;
+    for (int i = 0; i < 100; i++) {
+      original.push_back(new Circle(i, -i, i % 5));
+    }
+
+    // makes sure a copy has the same shapes in the same order and the same back
+    CanvasList copy(original);
+    REQUIRE(copy.size() == 100);
+    REQUIRE(copy.back()->value->getX() == 99);
+    for (int i = 0; i < 100; i++) {
+      REQUIRE(copy.shapeAt(i) != original.shapeAt(i));
+      REQUIRE(copy.shapeAt(i)->printShape() == original.shapeAt(i)->printShape());
+    }
+  }
+}
+
+
+TEST_CASE("Node Pool") {
+  SECTION("Nodes Come From Slabs") {
+    CanvasList canvas;
+    for (int i = 0; i < NodePool::SLAB_NODES; i++) {
+      canvas.push_back(new Shape(i, i));
+    }
+
+    // makes sure a full slab of nodes only needed one heap allocation
+    PoolStats stats = canvas.poolStats();
+    REQUIRE(stats.slabAllocations == 1);
+    REQUIRE(stats.nodeAllocations == NodePool::SLAB_NODES);
+
+    // makes sure one more node asks for exactly one more slab
+    canvas.push_front(new Shape());
+    REQUIRE(canvas.poolStats().slabAllocations == 2);
+  }
+
+  SECTION("Steady State Reuses Nodes") {
+    CanvasList canvas;
+    for (int i = 0; i < 100; i++) {
+      canvas.push_back(new Circle(i, i, 1));
+    }
+    long slabsBefore = canvas.poolStats().slabAllocations;
+
+    // churns the list and makes sure released nodes are reused
+    for (int i = 0; i < 10000; i++) {
+      delete canvas.pop_front();
+      canvas.push_back(new Rect(i, i, 1, 1));
+      canvas.removeAt(50);
+      canvas.insertAfter(10, new Shape(i, i));
+    }
+    REQUIRE(canvas.size() == 100);
+    REQUIRE(canvas.poolStats().slabAllocations == slabsBefore);
+    REQUIRE(canvas.poolStats().nodeReleases == 20000);
+  }
+
+  SECTION("clear Releases Slabs") {
+    CanvasList canvas;
+    for (int i = 0; i < 3 * NodePool::SLAB_NODES; i++) {
+      canvas.push_front(new Shape(i, i));
+    }
+    REQUIRE(canvas.poolStats().slabAllocations == 3);
+
+    // makes sure clearing hands every slab back in one go
+    canvas.clear();
+    REQUIRE(canvas.poolStats().slabReleases == 3);
+
+    // makes sure the list is usable again after clearing
+    canvas.push_back(new Shape(1, 2));
+    REQUIRE(canvas.find(1, 2) == 0);
+    REQUIRE(canvas.poolStats().slabAllocations == 4);
+  }
+}
+
+
+TEST_CASE("Canvas Vector Class") {
+  SECTION("Matches CanvasList") {
+    CanvasList list;
+    CanvasVector vec;
+
+    // applies the same operations to both containers
+    for (int i = 0; i < 9; i++) {
+      list.push_back(new Circle(i, i + 1, i));
+      vec.push_back(new Circle(i, i + 1, i));
+    }
+    list.push_front(new Rect(5, 5, 2, 3));
+    vec.push_front(new Rect(5, 5, 2, 3));
+    list.insertAfter(4, new RightTriangle(7, 7, 1, 1));
+    vec.insertAfter(4, new RightTriangle(7, 7, 1, 1));
+    list.insertAfter(10, new Shape(1, 1));
+    vec.insertAfter(10, new Shape(1, 1));
+    list.removeAt(2);
+    vec.removeAt(2);
+    list.removeEveryOther();
+    vec.removeEveryOther();
+    delete list.pop_front();
+    delete vec.pop_front();
+    delete list.pop_back();
+    delete vec.pop_back();
+
+    // makes sure both containers end up with the same shapes in the same order
+    REQUIRE(vec.size() == list.size());
+    for (int i = 0; i < list.size(); i++) {
+      REQUIRE(vec.shapeAt(i)->printShape() == list.shapeAt(i)->printShape());
+    }
+    REQUIRE(vec.find(4, 5) == list.find(4, 5));
+    REQUIRE(vec.find(100, 100) == -1);
+    REQUIRE(vec.shapeAt(-1) == nullptr);
+    REQUIRE(vec.shapeAt(vec.size()) == nullptr);
+  }
+
+  SECTION("Copies") {
+    CanvasList list;
+    list.push_back(new Shape(1, 2));
+    list.push_back(new Circle(3, 4, 5));
+
+    // makes sure converting and copying create new shapes with the same values
+    CanvasVector fromList(list);
+    CanvasVector copy(fromList);
+    CanvasVector assigned;
+    assigned.push_back(new Shape());
+    assigned = copy;
+
+    REQUIRE(assigned.size() == 2);
+    REQUIRE(fromList.shapeAt(0) != list.shapeAt(0));
+    REQUIRE(copy.shapeAt(1) != fromList.shapeAt(1));
+    REQUIRE(assigned.shapeAt(1) != copy.shapeAt(1));
+    REQUIRE(assigned.shapeAt(1)->printShape() == "It's a Circle at x: 3, y: 4, radius: 5");
+  }
+
+  SECTION("Empty Vector") {
+    CanvasVector vec;
+    REQUIRE(vec.isempty() == true);
+    REQUIRE(vec.pop_front() == nullptr);
+    REQUIRE(vec.pop_back() == nullptr);
+    vec.insertAfter(0, nullptr);
+    vec.removeAt(0);
+    REQUIRE(vec.size() == 0);
+  }
+}
+
+
+TEST_CASE("Find Index") {
+  SECTION("Matches Linear find") {
+    CanvasList indexed;
+    CanvasList plain;
+    indexed.enableFindIndex();
+    REQUIRE(indexed.hasFindIndex() == true);
+    REQUIRE(plain.hasFindIndex() == false);
+
+    // applies the same pseudo random operations to both lists
+    // coordinates are kept small so many shapes share a point
+    unsigned int seed = 12345;
+    for (int step = 0; step < 3000; step++) {
+      seed = seed * 1103515245 + 12345;
+      int op = (seed >> 16) % 9;
+      int x = (seed >> 8) % 5;
+      int y = (seed >> 4) % 5;
+      int idx = plain.size() > 0 ? static_cast<int>((seed >> 12) % plain.size()) : 0;
+
+      if (op == 0) {
+        indexed.push_front(new Shape(x, y));
+        plain.push_front(new Shape(x, y));
+      }
+      else if (op == 1 || op == 2) {
+        indexed.push_back(new Circle(x, y, 1));
+        plain.push_back(new Circle(x, y, 1));
+      }
+      else if (op == 3 && plain.size() > 0) {
+        indexed.insertAfter(idx, new Rect(x, y, 1, 1));
+        plain.insertAfter(idx, new Rect(x, y, 1, 1));
+      }
+      else if (op == 4) {
+        indexed.removeAt(idx);
+        plain.removeAt(idx);
+      }
+      else if (op == 5) {
+        delete indexed.pop_front();
+        delete plain.pop_front();
+      }
+      else if (op == 6) {
+        delete indexed.pop_back();
+        delete plain.pop_back();
+      }
+      else if (op == 7 && plain.size() > 0) {
+        // moves a shape through its setters
+        indexed.shapeAt(idx)->setX(x);
+        plain.shapeAt(idx)->setX(x);
+        indexed.shapeAt(idx)->setY(y);
+        plain.shapeAt(idx)->setY(y);
+      }
+      else if (op == 8 && step % 50 == 0) {
+        indexed.removeEveryOther();
+        plain.removeEveryOther();
+      }
+
+      REQUIRE(indexed.size() == plain.size());
+      REQUIRE(indexed.find(x, y) == plain.find(x, y));
+    }
+
+    // makes sure every point agrees after all operations
+    for (int x = 0; x < 5; x++) {
+      for (int y = 0; y < 5; y++) {
+        REQUIRE(indexed.find(x, y) == plain.find(x, y));
+      }
+    }
+  }
+
+  SECTION("Concurrent Readers") {
+    CanvasList canvas;
+    canvas.enableFindIndex();
+    canvas.enableSpatialIndex(4);
+    for (int i = 0; i < 2000; i++) {
+      canvas.push_back(new Shape(i, i));
+    }
+
+    // makes sure readers racing to renumber after a middle removal all
+    // see the same indices
+    canvas.removeAt(10);
+    vector<thread> readers;
+    atomic<int> wrong(0);
+    for (int t = 0; t < 4; t++) {
+      readers.emplace_back([&canvas, &wrong]() {
+        for (int i = 1000; i < 1100; i++) {
+          if (canvas.find(i, i) != i - 1 || canvas.shapesAt(i, i) != vector<int>{i - 1}) {
+            wrong++;
+          }
+        }
+      });
+    }
+    for (thread &reader : readers) {
+      reader.join();
+    }
+    REQUIRE(wrong == 0);
+  }
+
+  SECTION("Popped Shapes Are Not Tracked") {
+    CanvasList canvas;
+    canvas.enableFindIndex();
+    canvas.push_back(new Shape(1, 1));
+    canvas.push_back(new Shape(2, 2));
+
+    // makes sure moving a shape after it left the list does not touch the index
+    Shape *popped = canvas.pop_front();
+    REQUIRE(popped->getObserver() == nullptr);
+    popped->setX(2);
+    REQUIRE(canvas.find(2, 2) == 0);
+    REQUIRE(canvas.find(1, 1) == -1);
+    delete popped;
+
+    // makes sure clearing empties the index too
+    canvas.clear();
+    REQUIRE(canvas.find(2, 2) == -1);
+    canvas.push_front(new Shape(2, 2));
+    REQUIRE(canvas.find(2, 2) == 0);
+  }
+
+  SECTION("Enable And Copy") {
+    CanvasList canvas;
+    canvas.push_back(new Shape(1, 1));
+    canvas.push_back(new Shape(3, 3));
+    canvas.push_front(new Shape(3, 3));
+
+    // makes sure the index picks up shapes added before it was enabled
+    canvas.enableFindIndex();
+    REQUIRE(canvas.find(3, 3) == 0);
+    REQUIRE(canvas.find(1, 1) == 1);
+
+    // makes sure a copy keeps the index and follows its own shapes
+    CanvasList copy(canvas);
+    REQUIRE(copy.hasFindIndex() == true);
+    copy.shapeAt(1)->setY(5);
+    REQUIRE(copy.find(1, 5) == 1);
+    REQUIRE(canvas.find(1, 5) == -1);
+
+    canvas.disableFindIndex();
+    REQUIRE(canvas.find(3, 3) == 0);
+  }
+}
+
+
+TEST_CASE("Shape Bounds And Containment") {
+  SECTION("Basic Shape") {
+    Shape shape(2, 3);
+    Bounds b = shape.getBounds();
+    REQUIRE(b.minX == 2);
+    REQUIRE(b.maxX == 2);
+    REQUIRE(b.minY == 3);
+    REQUIRE(b.maxY == 3);
+    REQUIRE(shape.contains(2, 3) == true);
+    REQUIRE(shape.contains(2, 4) == false);
+  }
+
+  SECTION("Circle") {
+    Circle circle(0, 0, 5);
+    Bounds b = circle.getBounds();
+    REQUIRE(b.minX == -5);
+    REQUIRE(b.maxY == 5);
+    REQUIRE(circle.contains(3, 4) == true);
+    REQUIRE(circle.contains(4, 4) == false);
+    REQUIRE(circle.contains(-5, 0) == true);
+  }
+
+  SECTION("Rectangle") {
+    Rect rect(1, 1, 4, 2);
+    Bounds b = rect.getBounds();
+    REQUIRE(b.minX == 1);
+    REQUIRE(b.maxX == 5);
+    REQUIRE(b.maxY == 3);
+    REQUIRE(rect.contains(5, 3) == true);
+    REQUIRE(rect.contains(6, 3) == false);
+  }
+
+  SECTION("Right Triangle") {
+    RightTriangle tri(0, 0, 4, 4);
+    REQUIRE(tri.getBounds().maxX == 4);
+    REQUIRE(tri.contains(0, 0) == true);
+    REQUIRE(tri.contains(2, 2) == true);
+    REQUIRE(tri.contains(3, 2) == false);
+    REQUIRE(tri.contains(4, 0) == true);
+    REQUIRE(tri.contains(-1, 0) == false);
+
+    // makes sure a triangle with negative base mirrors across its origin
+    RightTriangle mirrored(0, 0, -4, 4);
+    REQUIRE(mirrored.getBounds().minX == -4);
+    REQUIRE(mirrored.contains(-2, 2) == true);
+    REQUIRE(mirrored.contains(2, 2) == false);
+  }
+
+  SECTION("Extreme Coordinates") {
+    // makes sure far apart points do not overflow the distance test
+    Circle edge(INT_MAX, 0, 5);
+    REQUIRE(edge.contains(INT_MIN, 0) == false);
+    REQUIRE(edge.contains(INT_MAX - 5, 0) == true);
+    Circle huge(INT_MAX, INT_MAX, INT_MIN);
+    REQUIRE(huge.contains(INT_MIN, INT_MIN) == false);
+    REQUIRE(huge.contains(0, 0) == false);
+    REQUIRE(huge.contains(INT_MAX - 1000, INT_MAX) == true);
+
+    // makes sure bounds past the int range are clamped to it
+    Bounds b = huge.getBounds();
+    REQUIRE(b.minX == -1);
+    REQUIRE(b.minY == -1);
+    REQUIRE(b.maxX == INT_MAX);
+    REQUIRE(b.maxY == INT_MAX);
+    b = Rect(INT_MAX, INT_MIN, 10, -10).getBounds();
+    REQUIRE(b.minX == INT_MAX);
+    REQUIRE(b.maxX == INT_MAX);
+    REQUIRE(b.minY == INT_MIN);
+    REQUIRE(b.maxY == INT_MIN);
+    b = RightTriangle(INT_MIN, INT_MAX, -1, 1).getBounds();
+    REQUIRE(b.minX == INT_MIN);
+    REQUIRE(b.maxY == INT_MAX);
+  }
+}
+
+TEST_CASE("Spatial Grid") {
+  SECTION("Matches Linear Scan") {
+    CanvasList gridded;
+    CanvasList plain;
+    gridded.enableSpatialIndex(8);
+    REQUIRE(gridded.hasSpatialIndex() == true);
+
+    // fills both lists with the same mix of small, large and negative shapes
+    unsigned int seed = 777;
+    for (int i = 0; i < 400; i++) {
+      seed = seed * 1103515245 + 12345;
+      int x = static_cast<int>((seed >> 8) % 200) - 100;
+      int y = static_cast<int>((seed >> 4) % 200) - 100;
+      int size = (i % 50 == 0) ? 150 : static_cast<int>((seed >> 16) % 12);
+      Shape *a;
+      Shape *b;
+      switch (i % 4) {
+        case 0: a = new Circle(x, y, size); b = new Circle(x, y, size); break;
+        case 1: a = new Rect(x, y, size, size / 2 + 1); b = new Rect(x, y, size, size / 2 + 1); break;
+        case 2: a = new RightTriangle(x, y, size, -size); b = new RightTriangle(x, y, size, -size); break;
+        default: a = new Shape(x, y); b = new Shape(x, y); break;
+      }
+      gridded.push_back(a);
+      plain.push_back(b);
+    }
+
+    // changes some shapes through their setters and removes a few
+    for (int i = 0; i < 400; i += 7) {
+      gridded.shapeAt(i)->setX(i - 200);
+      plain.shapeAt(i)->setX(i - 200);
+    }
+    dynamic_cast<Circle *>(gridded.shapeAt(4))->setRadius(90);
+    dynamic_cast<Circle *>(plain.shapeAt(4))->setRadius(90);
+    dynamic_cast<Rect *>(gridded.shapeAt(5))->setWidth(33);
+    dynamic_cast<Rect *>(plain.shapeAt(5))->setWidth(33);
+    dynamic_cast<RightTriangle *>(gridded.shapeAt(6))->setBase(-40);
+    dynamic_cast<RightTriangle *>(plain.shapeAt(6))->setBase(-40);
+    gridded.removeAt(100);
+    plain.removeAt(100);
+    gridded.removeEveryOther();
+    plain.removeEveryOther();
+    gridded.insertAfter(3, new Circle(0, 0, 20));
+    plain.insertAfter(3, new Circle(0, 0, 20));
+    delete gridded.pop_front();
+    delete plain.pop_front();
+
+    // makes sure point queries agree everywhere on a coarse lattice
+    for (int px = -120; px <= 120; px += 5) {
+      for (int py = -120; py <= 120; py += 5) {
+        REQUIRE(gridded.shapesAt(px, py) == plain.shapesAt(px, py));
+      }
+    }
+
+    // makes sure rectangle queries agree, including one bigger than the canvas
+    REQUIRE(gridded.shapesIn(Bounds{-10, -10, 10, 10}) == plain.shapesIn(Bounds{-10, -10, 10, 10}));
+    REQUIRE(gridded.shapesIn(Bounds{30, -90, 31, 90}) == plain.shapesIn(Bounds{30, -90, 31, 90}));
+    REQUIRE(gridded.shapesIn(Bounds{-100000, -100000, 100000, 100000}).size() == static_cast<size_t>(plain.size()));
+  }
+
+  SECTION("Order And Copies") {
+    CanvasList canvas;
+    canvas.push_back(new Rect(0, 0, 10, 10));
+    canvas.push_back(new Circle(5, 5, 2));
+    canvas.push_front(new Shape(5, 5));
+    canvas.enableSpatialIndex();
+
+    // makes sure covering shapes come back in list order
+    vector<int> hits = canvas.shapesAt(5, 5);
+    REQUIRE(hits == vector<int>{0, 1, 2});
+    REQUIRE(canvas.shapesAt(9, 9) == vector<int>{1});
+
+    // makes sure a copy has its own grid
+    CanvasList copy(canvas);
+    REQUIRE(copy.hasSpatialIndex() == true);
+    copy.shapeAt(1)->setX(100);
+    REQUIRE(copy.shapesAt(9, 9).empty());
+    REQUIRE(canvas.shapesAt(9, 9) == vector<int>{1});
+
+    canvas.clear();
+    REQUIRE(canvas.shapesAt(5, 5).empty());
+  }
+
+  SECTION("Assignment Moves Shapes") {
+    // makes sure the grid sees the new size, not just the new coordinates
+    CanvasList canvas;
+    canvas.enableSpatialIndex();
+    canvas.push_back(new Circle(0, 0, 1));
+    canvas.push_back(new Rect(0, 0, 1, 1));
+    canvas.push_back(new RightTriangle(0, 0, 1, 1));
+    *dynamic_cast<Circle *>(canvas.shapeAt(0)) = Circle(100, 100, 60);
+    REQUIRE(canvas.shapesAt(150, 100) == vector<int>{0});
+    *dynamic_cast<Rect *>(canvas.shapeAt(1)) = Rect(-300, -300, 80, 80);
+    REQUIRE(canvas.shapesAt(-250, -250) == vector<int>{1});
+    *dynamic_cast<RightTriangle *>(canvas.shapeAt(2)) = RightTriangle(300, 300, 90, 90);
+    REQUIRE(canvas.shapesAt(310, 310) == vector<int>{2});
+    REQUIRE(canvas.shapesAt(0, 0).empty());
+  }
+}
+
+
+TEST_CASE("Shape BVH") {
+  // fills a canvas with tiny markers and a few huge backgrounds
+  CanvasList canvas;
+  unsigned int seed = 99;
+  for (int i = 0; i < 700; i++) {
+    seed = seed * 1103515245 + 12345;
+    int x = static_cast<int>((seed >> 8) % 1000);
+    int y = static_cast<int>((seed >> 4) % 1000);
+    switch (i % 4) {
+      case 0: canvas.push_back(new Shape(x, y)); break;
+      case 1: canvas.push_back(new Circle(x, y, 1 + i % 5)); break;
+      case 2: canvas.push_back(new Rect(x, y, i % 97 == 0 ? 800 : 3, 4)); break;
+      default: canvas.push_back(new RightTriangle(x, y, 6, i % 89 == 0 ? 700 : 5)); break;
+    }
+  }
+  ShapeBVH bvh(canvas);
+
+  SECTION("Build") {
+    REQUIRE(bvh.size() == 700);
+    REQUIRE(bvh.height() >= 3);
+
+    ShapeBVH empty;
+    REQUIRE(empty.size() == 0);
+    REQUIRE(empty.height() == 0);
+    REQUIRE(empty.queryPoint(0, 0).empty());
+    REQUIRE(empty.nearest(0, 0, 3).empty());
+  }
+
+  SECTION("Point And Window Queries") {
+    // makes sure the tree agrees with a linear scan of the canvas
+    for (int px = 0; px < 1000; px += 37) {
+      for (int py = 0; py < 1000; py += 41) {
+        REQUIRE(bvh.queryPoint(px, py) == canvas.shapesAt(px, py));
+      }
+    }
+    REQUIRE(bvh.queryWindow(Bounds{100, 100, 300, 200}) == canvas.shapesIn(Bounds{100, 100, 300, 200}));
+    REQUIRE(bvh.queryWindow(Bounds{-5, -5, 2000, 2000}).size() == 700);
+  }
+
+  SECTION("Nearest Query") {
+    int px = 500;
+    int py = 250;
+
+    // ranks every shape by distance to its bounds, then by index
+    vector<pair<long long, int>> ranked;
+    for (int i = 0; i < canvas.size(); i++) {
+      Bounds b = canvas.shapeAt(i)->getBounds();
+      long long dx = px < b.minX ? b.minX - px : (px > b.maxX ? px - b.maxX : 0);
+      long long dy = py < b.minY ? b.minY - py : (py > b.maxY ? py - b.maxY : 0);
+      ranked.push_back({dx * dx + dy * dy, i});
+    }
+    sort(ranked.begin(), ranked.end());
+
+    vector<int> nearest = bvh.nearest(px, py, 10);
+    REQUIRE(nearest.size() == 10);
+    for (int i = 0; i < 10; i++) {
+      REQUIRE(nearest[i] == ranked[i].second);
+    }
+    REQUIRE(bvh.nearest(px, py, 1000).size() == 700);
+  }
+
+  SECTION("Nearest Ties") {
+    // makes sure a shape at the same distance as an unexpanded node does
+    // not beat a lower index inside that node
+    for (int n = ShapeBVH::NODE_CAPACITY * 40; n <= ShapeBVH::NODE_CAPACITY * 50; n += 3) {
+      CanvasList ties;
+      ties.push_back(new Rect(5000, 5000, 4, 4));
+      for (int i = 0; i < n; i++) {
+        ties.push_back(new Rect(i % 60 * 40, i / 60 * 40, 2, 2));
+      }
+      ties.push_back(new Rect(-10000, -10000, 30000, 30000));
+      ShapeBVH tree(ties);
+      REQUIRE(tree.nearest(5001, 5001, 1) == vector<int>{0});
+      REQUIRE(tree.nearest(5001, 5001, 2) == vector<int>{0, n + 1});
+    }
+  }
+}
+
+
+TEST_CASE("Rasterizer") {
+  SECTION("Spans Match contains") {
+    // makes sure every row span covers exactly the pixels contains accepts
+    Shape *shapes[] = {
+      new Shape(3, 4), new Circle(10, 10, 7), new Circle(0, 0, 0), new Rect(2, 3, 9, -4),
+      new RightTriangle(5, 5, 8, 11), new RightTriangle(20, 20, -9, -6), new RightTriangle(1, 1, 0, 5)
+    };
+    for (Shape *shape : shapes) {
+      for (int py = -25; py <= 35; py++) {
+        int minX = 0;
+        int maxX = -1;
+        bool hit = shape->rowSpan(py, minX, maxX);
+        for (int px = -25; px <= 35; px++) {
+          REQUIRE(shape->contains(px, py) == (hit && px >= minX && px <= maxX));
+        }
+      }
+      delete shape;
+    }
+  }
+
+  SECTION("Extreme Coordinates") {
+    // makes sure spans and containment agree when the distances overflow int
+    Shape *shapes[] = {
+      new Circle(INT_MAX, INT_MIN, 5), new Circle(INT_MIN, 0, INT_MAX),
+      new RightTriangle(INT_MAX, INT_MAX, INT_MIN, INT_MIN), new RightTriangle(INT_MIN, INT_MIN, INT_MAX, INT_MAX)
+    };
+    int coords[] = {INT_MIN, INT_MIN + 3, -1, 0, 1, INT_MAX - 3, INT_MAX};
+    for (Shape *shape : shapes) {
+      for (int py : coords) {
+        int minX = 0;
+        int maxX = -1;
+        bool hit = shape->rowSpan(py, minX, maxX);
+        for (int px : coords) {
+          REQUIRE(shape->contains(px, py) == (hit && px >= minX && px <= maxX));
+        }
+      }
+      delete shape;
+    }
+    Circle far(INT_MIN, 0, 3);
+    REQUIRE(!far.contains(INT_MAX, 0));
+    REQUIRE(far.contains(INT_MIN + 3, 0));
+    RightTriangle big(INT_MIN, INT_MIN, INT_MAX, INT_MAX);
+    REQUIRE(big.contains(INT_MIN / 2 - 1, INT_MIN / 2 - 1));
+    REQUIRE(!big.contains(INT_MIN / 2, INT_MIN / 2));
+  }
+
+  SECTION("Render Canvas") {
+    CanvasList canvas;
+    canvas.push_back(new Rect(0, 0, 15, 15));
+    canvas.push_back(new Circle(8, 8, 4));
+    canvas.push_back(new RightTriangle(-3, 12, 6, 6));
+
+    Framebuffer fb(16, 16);
+    long written = Rasterizer::render(canvas, fb);
+
+    // makes sure later shapes are painted over earlier ones and every pixel is clipped
+    for (int y = 0; y < 16; y++) {
+      for (int x = 0; x < 16; x++) {
+        uint32_t expected = 0;
+        for (int i = 0; i < canvas.size(); i++) {
+          if (canvas.shapeAt(i)->contains(x, y)) {
+            expected = Rasterizer::colorOf(*canvas.shapeAt(i));
+          }
+        }
+        REQUIRE(fb.getPixel(x, y) == expected);
+      }
+    }
+    REQUIRE(written > 256);
+    REQUIRE(fb.getPixel(16, 0) == 0);
+  }
+
+  SECTION("Image Files") {
+    Framebuffer fb(3, 2);
+    fb.clear(Framebuffer::rgba(255, 255, 255));
+    fb.fillSpan(1, -5, 1, Framebuffer::rgba(255, 0, 0));
+    REQUIRE(fb.writePPM("raster_test.ppm") == true);
+    REQUIRE(fb.writePGM("raster_test.pgm") == true);
+
+    // makes sure the header and pixel bytes are laid out as expected
+    ifstream ppm("raster_test.ppm", ios::binary);
+    string contents((istreambuf_iterator<char>(ppm)), istreambuf_iterator<char>());
+    REQUIRE(contents.substr(0, 11) == "P6\n3 2\n255\n");
+    REQUIRE(contents.size() == 11 + 3 * 2 * 3);
+    REQUIRE(static_cast<unsigned char>(contents[11 + 9]) == 255);
+    REQUIRE(static_cast<unsigned char>(contents[11 + 10]) == 0);
+
+    ifstream pgm("raster_test.pgm", ios::binary);
+    string gray((istreambuf_iterator<char>(pgm)), istreambuf_iterator<char>());
+    REQUIRE(gray.substr(0, 11) == "P5\n3 2\n255\n");
+    REQUIRE(static_cast<unsigned char>(gray[11]) == 255);
+
+    remove("raster_test.ppm");
+    remove("raster_test.pgm");
+  }
+}
+
+
+TEST_CASE("Tile Renderer") {
+  SECTION("Thread Pool Runs Every Task") {
+    ThreadPool pool(3);
+    REQUIRE(pool.size() == 3);
+
+    // makes sure every task runs exactly once across several batches
+    for (int round = 0; round < 20; round++) {
+      vector<int> hits(257, 0);
+      pool.run(257, [&](int task) { hits[task]++; });
+      for (int count : hits) {
+        REQUIRE(count == 1);
+      }
+    }
+    pool.run(0, [](int) {});
+  }
+
+  SECTION("Matches Serial Rasterizer") {
+    CanvasList canvas;
+    unsigned int seed = 4242;
+    for (int i = 0; i < 500; i++) {
+      seed = seed * 1103515245 + 12345;
+      int x = static_cast<int>((seed >> 8) % 260) - 20;
+      int y = static_cast<int>((seed >> 4) % 200) - 20;
+      int size = 1 + static_cast<int>((seed >> 16) % (i % 25 == 0 ? 120 : 15));
+      switch (i % 4) {
+        case 0: canvas.push_back(new Shape(x, y)); break;
+        case 1: canvas.push_back(new Circle(x, y, size)); break;
+        case 2: canvas.push_back(new Rect(x, y, size, size / 2)); break;
+        default: canvas.push_back(new RightTriangle(x, y, -size, size)); break;
+      }
+    }
+
+    Framebuffer serial(230, 170);
+    long serialPixels = Rasterizer::render(canvas, serial);
+
+    // makes sure tiles of any size produce the same image on any number of threads
+    for (int threads : {1, 2, 4}) {
+      ThreadPool pool(threads);
+      for (int tileSize : {7, 16, 64, 500}) {
+        TileRenderer renderer(pool, tileSize);
+        Framebuffer tiled(230, 170);
+        REQUIRE(renderer.render(canvas, tiled) == serialPixels);
+        for (int y = 0; y < 170; y++) {
+          for (int x = 0; x < 230; x++) {
+            REQUIRE(tiled.getPixel(x, y) == serial.getPixel(x, y));
+          }
+        }
+      }
+    }
+  }
+}
+
+
+TEST_CASE("Buffered Draw") {
+  CanvasList canvas;
+  int values[] = {0, 7, -13, 250, INT_MAX, INT_MIN, 100000};
+  for (int i = 0; i < 20000; i++) {
+    int a = values[i % 7];
+    int b = values[(i / 7) % 7];
+    switch (i % 4) {
+      case 0: canvas.push_back(new Shape(a, b)); break;
+      case 1: canvas.push_back(new Circle(b, a, i)); break;
+      case 2: canvas.push_back(new Rect(a, i, b, -i)); break;
+      default: canvas.push_back(new RightTriangle(i, a, b, a)); break;
+    }
+  }
+
+  // builds the text the old draw() printed, one printShape line per shape
+  string expected;
+  for (ShapeNode *curr = canvas.front(); curr != nullptr; curr = curr->next) {
+    expected += curr->value->printShape() + "\n";
+  }
+
+  SECTION("Appending printShape") {
+    // makes sure appending gives the same text and reports its length
+    string out = "prefix";
+    for (int i = 0; i < 4; i++) {
+      size_t length = canvas.shapeAt(i)->printShape(out);
+      REQUIRE(length == canvas.shapeAt(i)->printShape().size());
+    }
+    REQUIRE(out == "prefix" + canvas.shapeAt(0)->printShape() + canvas.shapeAt(1)->printShape() +
+                   canvas.shapeAt(2)->printShape() + canvas.shapeAt(3)->printShape());
+  }
+
+  SECTION("Draw To Stream") {
+    ostringstream out;
+    canvas.draw(out);
+    REQUIRE(out.str() == expected);
+  }
+
+  SECTION("Draw To File Descriptor") {
+    int fd = open("draw_test.txt", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    REQUIRE(fd >= 0);
+    canvas.draw(fd);
+    close(fd);
+
+    ifstream in("draw_test.txt", ios::binary);
+    string contents((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    REQUIRE(contents == expected);
+    remove("draw_test.txt");
+  }
+}
+
+
+// Star overrides only the string printShape, the way code written before
+// the buffer overload did
+class Star : public Circle
+{
+  public:
+    Star(int x, int y, int r) : Circle(x, y, r) {}
+    Star* copy() { return new Star(getX(), getY(), getRadius()); }
+    string printShape() const { return "It's a Star with " + Circle::printShape(); }
+};
+
+// Badge overrides only the buffer printShape
+class Badge : public Rect
+{
+  public:
+    Badge(int x, int y) : Rect(x, y, 1, 1) {}
+    Badge* copy() { return new Badge(getX(), getY()); }
+    using Rect::printShape;
+    size_t printShape(char *buffer, size_t capacity) const {
+      size_t length = Rect::printShape(buffer, capacity);
+      if (length < capacity) {
+        buffer[length] = '!';
+      }
+      return length + 1;
+    }
+};
+
+TEST_CASE("printShape Into Buffers") {
+  SECTION("Subclass Overrides Reach draw") {
+    // makes sure draw prints whatever each shape's printShape() returns
+    CanvasList list;
+    list.push_back(new Star(1, 2, 3));
+    list.push_back(new Badge(4, 5));
+    list.push_back(new Circle(6, 7, 8));
+    REQUIRE(list.shapeAt(0)->printShape() == "It's a Star with It's a Circle at x: 1, y: 2, radius: 3");
+    REQUIRE(list.shapeAt(1)->printShape() == "It's a Rectangle at x: 4, y: 5 with width: 1 and height: 1!");
+
+    string expected;
+    for (int i = 0; i < list.size(); i++) {
+      expected += list.shapeAt(i)->printShape() + "\n";
+    }
+    ostringstream out;
+    list.draw(out);
+    REQUIRE(out.str() == expected);
+
+    string appended = "> ";
+    REQUIRE(list.shapeAt(0)->printShape(appended) == list.shapeAt(0)->printShape().size());
+    REQUIRE(appended == "> " + list.shapeAt(0)->printShape());
+  }
+
+  Shape *shapes[] = {
+    new Shape(INT_MIN, INT_MAX), new Circle(-1, 0, INT_MIN),
+    new Rect(INT_MIN, INT_MIN, INT_MIN, INT_MIN), new RightTriangle(INT_MIN, INT_MIN, INT_MIN, INT_MIN)
+  };
+
+  SECTION("Char Buffer") {
+    char buffer[Shape::MAX_TEXT_LENGTH];
+    for (Shape *shape : shapes) {
+      // makes sure the buffer form writes the same text as the string form
+      size_t length = shape->printShape(buffer, sizeof(buffer));
+      REQUIRE(length <= Shape::MAX_TEXT_LENGTH);
+      REQUIRE(string(buffer, length) == shape->printShape());
+    }
+    REQUIRE(string(buffer, shapes[3]->printShape(buffer, sizeof(buffer))) ==
+            "It's a Right Triangle at x: -2147483648, y: -2147483648 with base: -2147483648 and height: -2147483648");
+  }
+
+  SECTION("Short Buffer") {
+    // makes sure a short buffer is filled without overrunning and reports the full length
+    char buffer[12] = "XXXXXXXXXXX";
+    Circle circle(2, 4, 3);
+    size_t length = circle.printShape(buffer, 6);
+    REQUIRE(length == circle.printShape().size());
+    REQUIRE(string(buffer, 6) == "It's a");
+    REQUIRE(buffer[6] == 'X');
+    REQUIRE(circle.printShape(nullptr, 0) == length);
+  }
+
+  SECTION("Reused String") {
+    // makes sure appending to a string with spare room does not reallocate
+    string out;
+    out.reserve(4096);
+    const char *storage = out.data();
+    for (int i = 0; i < 20; i++) {
+      shapes[i % 4]->printShape(out);
+    }
+    REQUIRE(out.data() == storage);
+    REQUIRE(out.substr(0, shapes[0]->printShape().size()) == shapes[0]->printShape());
+  }
+
+  for (Shape *shape : shapes) {
+    delete shape;
+  }
+}
+
+
+TEST_CASE("Binary Canvas Files") {
+  CanvasList canvas;
+  canvas.push_back(new Circle(2, 4, 3));
+  canvas.push_back(new Rect(-1, INT_MAX, 5, 6));
+  canvas.push_back(new RightTriangle(1, 2, 3, 4));
+  canvas.push_back(new Shape(INT_MIN, 7));
+  for (int i = 0; i < 10000; i++) {
+    canvas.push_back(new Circle(i, -i, i % 9));
+  }
+
+  SECTION("Round Trip") {
+    stringstream buffer;
+    REQUIRE(canvas.save(buffer) == true);
+    REQUIRE(buffer.str().size() == CanvasFile::HEADER_SIZE + canvas.size() * CanvasFile::RECORD_SIZE);
+
+    // makes sure loading replaces the old contents with identical shapes
+    CanvasList loaded;
+    loaded.push_back(new Shape(99, 99));
+    REQUIRE(loaded.load(buffer) == true);
+    REQUIRE(loaded.size() == canvas.size());
+    for (int i = 0; i < canvas.size(); i++) {
+      REQUIRE(loaded.shapeAt(i)->getType() == canvas.shapeAt(i)->getType());
+      REQUIRE(loaded.shapeAt(i)->printShape() == canvas.shapeAt(i)->printShape());
+    }
+  }
+
+  SECTION("Byte Layout") {
+    CanvasList one;
+    one.push_back(new Circle(2, -1, 258));
+    ostringstream out;
+    one.save(out);
+
+    // makes sure the header and record are little endian with the documented layout
+    string bytes = out.str();
+    REQUIRE(bytes.size() == 36);
+    REQUIRE(bytes.substr(0, 4) == "SHPC");
+    REQUIRE(bytes[4] == 1);
+    REQUIRE(bytes[8] == 1);
+    REQUIRE(bytes[16] == SHAPE_CIRCLE);
+    REQUIRE(bytes[20] == 2);
+    REQUIRE(static_cast<unsigned char>(bytes[27]) == 0xff);
+    REQUIRE(bytes[28] == 2);
+    REQUIRE(bytes[29] == 1);
+    REQUIRE(bytes[32] == 0);
+  }
+
+  SECTION("Invalid Files") {
+    ostringstream out;
+    canvas.save(out);
+    string good = out.str();
+    CanvasList loaded;
+
+    // makes sure a bad magic number, a newer version, a cut off file and an unknown type all fail
+    string badMagic = good;
+    badMagic[0] = 'X';
+    istringstream in1(badMagic);
+    REQUIRE(loaded.load(in1) == false);
+
+    string badVersion = good;
+    badVersion[4] = 2;
+    istringstream in2(badVersion);
+    REQUIRE(loaded.load(in2) == false);
+
+    istringstream in3(good.substr(0, good.size() - 1));
+    REQUIRE(loaded.load(in3) == false);
+    REQUIRE(loaded.size() == 0);
+
+    string badType = good;
+    badType[CanvasFile::HEADER_SIZE + 5 * CanvasFile::RECORD_SIZE] = 9;
+    istringstream in4(badType);
+    REQUIRE(loaded.load(in4) == false);
+    REQUIRE(loaded.isempty() == true);
+
+    REQUIRE(loaded.load(string("no_such_canvas_file.bin")) == false);
+  }
+
+  SECTION("Corrupt Record Types") {
+    char record[CanvasFile::RECORD_SIZE];
+    CanvasFile::writeShape(record, Rect(1, 2, 3, 4));
+
+    // makes sure an unknown type is rejected without touching the output record
+    uint32_t types[] = {7, 0xFFFFFFFF};
+    for (uint32_t type : types) {
+      char corrupt[CanvasFile::RECORD_SIZE];
+      memcpy(corrupt, record, sizeof(record));
+      for (int i = 0; i < 4; i++) {
+        corrupt[i] = static_cast<char>(type >> (8 * i));
+      }
+      ShapeRecord out{SHAPE_CIRCLE, 5, 6, 7, 8};
+      REQUIRE(CanvasFile::readRecord(corrupt, out) == false);
+      REQUIRE(out.type == SHAPE_CIRCLE);
+      REQUIRE(out.x == 5);
+      REQUIRE(out.b == 8);
+      REQUIRE(CanvasFile::readShape(corrupt) == nullptr);
+    }
+
+    ShapeRecord out{SHAPE_CIRCLE, 5, 6, 7, 8};
+    REQUIRE(CanvasFile::readRecord(record, out) == true);
+    REQUIRE(out.type == SHAPE_RECT);
+    REQUIRE(out.b == 4);
+  }
+
+  SECTION("Files On Disk") {
+    REQUIRE(canvas.save(string("canvas_test.bin")) == true);
+    CanvasList loaded;
+    REQUIRE(loaded.load(string("canvas_test.bin")) == true);
+    REQUIRE(loaded.size() == canvas.size());
+    REQUIRE(loaded.shapeAt(1)->printShape() == canvas.shapeAt(1)->printShape());
+    remove("canvas_test.bin");
+  }
+}
+
+
+TEST_CASE("Mapped Canvas View") {
+  CanvasList canvas;
+  for (int i = 0; i < 5000; i++) {
+    switch (i % 4) {
+      case 0: canvas.push_back(new Shape(i, i % 10)); break;
+      case 1: canvas.push_back(new Circle(-i, i % 10, i)); break;
+      case 2: canvas.push_back(new Rect(i % 7, i % 10, i, 2)); break;
+      default: canvas.push_back(new RightTriangle(i, -i, 3, i)); break;
+    }
+  }
+  REQUIRE(canvas.save(string("view_test.bin")) == true);
+
+  SECTION("Queries Match CanvasList") {
+    CanvasView view;
+    REQUIRE(view.isopen() == false);
+    REQUIRE(view.open("view_test.bin") == true);
+    REQUIRE(view.isopen() == true);
+    REQUIRE(view.size() == canvas.size());
+
+    // makes sure every record decodes to the shape that was saved
+    ShapeRecord record;
+    for (int i = 0; i < canvas.size(); i++) {
+      REQUIRE(view.shapeAt(i, record) == true);
+      REQUIRE(record.type == canvas.shapeAt(i)->getType());
+      REQUIRE(record.x == canvas.shapeAt(i)->getX());
+      string text;
+      record.printShape(text);
+      REQUIRE(text == canvas.shapeAt(i)->printShape());
+    }
+    REQUIRE(view.shapeAt(-1, record) == false);
+    REQUIRE(view.shapeAt(view.size(), record) == false);
+
+    REQUIRE(view.find(3, 2) == canvas.find(3, 2));
+    REQUIRE(view.find(-9, 9) == canvas.find(-9, 9));
+    REQUIRE(view.find(123456, 0) == -1);
+
+    // makes sure drawing from the file matches drawing the list
+    ostringstream fromView;
+    ostringstream fromList;
+    view.draw(fromView);
+    canvas.draw(fromList);
+    REQUIRE(fromView.str() == fromList.str());
+
+    view.close();
+    REQUIRE(view.size() == 0);
+  }
+
+  SECTION("Invalid Files") {
+    CanvasView view;
+    REQUIRE(view.open("no_such_canvas_file.bin") == false);
+
+    // makes sure a file shorter than its header claims is refused
+    ifstream in("view_test.bin", ios::binary);
+    string bytes((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    ofstream out("view_short.bin", ios::binary);
+    out.write(bytes.data(), bytes.size() - 3);
+    out.close();
+    REQUIRE(view.open("view_short.bin") == false);
+    REQUIRE(view.isopen() == false);
+    remove("view_short.bin");
+  }
+
+  remove("view_test.bin");
+}
+
+TEST_CASE("Canvas Parser") {
+  CanvasList canvas;
+  for (int i = 0; i < 200; i++) {
+    switch (i % 4) {
+      case 0: canvas.push_back(new Shape(i, -i)); break;
+      case 1: canvas.push_back(new Circle(-i, i % 10, i)); break;
+      case 2: canvas.push_back(new Rect(i % 7, INT_MIN, i, -2)); break;
+      default: canvas.push_back(new RightTriangle(INT_MAX, -i, 3, i)); break;
+    }
+  }
+  ostringstream drawn;
+  canvas.draw(drawn);
+
+  SECTION("Round Trip") {
+    // makes sure every chunk size rebuilds the same canvas, even when
+    // lines are split across chunks
+    for (size_t chunk : {size_t(1), size_t(7), size_t(64), CanvasParser::DEFAULT_CHUNK_SIZE}) {
+      CanvasList parsed;
+      CanvasParser parser(chunk);
+      REQUIRE(parser.parse(drawn.str(), parsed) == true);
+      REQUIRE(parser.shapesRead() == 200);
+      REQUIRE(parser.linesRead() == 200);
+      REQUIRE(parsed.size() == canvas.size());
+      for (int i = 0; i < canvas.size(); i++) {
+        REQUIRE(parsed.shapeAt(i)->getType() == canvas.shapeAt(i)->getType());
+        REQUIRE(parsed.shapeAt(i)->printShape() == canvas.shapeAt(i)->printShape());
+      }
+    }
+  }
+
+  SECTION("Appends To Existing Canvas") {
+    CanvasList parsed;
+    parsed.push_back(new Shape(1, 1));
+    CanvasParser parser;
+    REQUIRE(parser.parse(string("It's a Circle at x: 5, y: 6, radius: 7"), parsed) == true);
+    REQUIRE(parsed.size() == 2);
+    REQUIRE(parsed.shapeAt(1)->printShape() == "It's a Circle at x: 5, y: 6, radius: 7");
+  }
+
+  SECTION("Malformed Lines") {
+    string text = "It's a Shape at x: 1, y: 2\n"
+                  "\n"
+                  "It's a Shape at x: 1, y:\n"
+                  "It's a Circle at x: 1, y: 2, radius: 3 extra\n"
+                  "It's a Rectangle at x: 1, y: 2 with width: 99999999999 and height: 4\n"
+                  "It's a Right Triangle at x: 1, y: 2 with base: 3 and height: 4\r\n"
+                  "List size: 3\n";
+    CanvasList parsed;
+    CanvasParser parser;
+
+    // makes sure bad lines are skipped and reported with their line numbers
+    REQUIRE(parser.parse(text, parsed) == false);
+    REQUIRE(parsed.size() == 2);
+    REQUIRE(parser.errorTotal() == 4);
+    REQUIRE(parser.linesRead() == 7);
+    const vector<ParseError> &errors = parser.getErrors();
+    REQUIRE(errors.size() == 4);
+    REQUIRE(errors[0].line == 3);
+    REQUIRE(errors[0].text == "It's a Shape at x: 1, y:");
+    REQUIRE(errors[1].line == 4);
+    REQUIRE(errors[2].line == 5);
+    REQUIRE(errors[3].line == 7);
+    REQUIRE(errors[3].text == "List size: 3");
+  }
+
+  SECTION("Files And Descriptors") {
+    int fd = open("parser_test.txt", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    REQUIRE(fd >= 0);
+    canvas.draw(fd);
+    close(fd);
+
+    CanvasList parsed;
+    CanvasParser parser(100);
+    REQUIRE(parser.parseFile("parser_test.txt", parsed) == true);
+    REQUIRE(parsed.size() == canvas.size());
+    REQUIRE(parsed.shapeAt(199)->printShape() == canvas.shapeAt(199)->printShape());
+
+    CanvasList missing;
+    REQUIRE(parser.parseFile("no_such_canvas_file.txt", missing) == false);
+    REQUIRE(missing.size() == 0);
+    remove("parser_test.txt");
+  }
+}
+
+TEST_CASE("Value Canvas") {
+  SECTION("Shape Values") {
+    Rect rect(1, 2, 3, 4);
+    ShapeValue value = toValue(rect);
+    REQUIRE(holds_alternative<Rect>(value));
+    REQUIRE(value.index() == SHAPE_RECT);
+    REQUIRE(asShape(value).getType() == SHAPE_RECT);
+    string text;
+    REQUIRE(printValue(value, text) == rect.printShape().size());
+    REQUIRE(text == rect.printShape());
+
+    // makes sure each alternative converts back to the right heap class
+    Circle circle(5, 6, 7);
+    RightTriangle triangle(1, 1, 2, 3);
+    Shape basic(8, 9);
+    for (Shape *original : {static_cast<Shape *>(&rect), static_cast<Shape *>(&circle),
+                            static_cast<Shape *>(&triangle), &basic}) {
+      Shape *copy = toShape(toValue(*original));
+      REQUIRE(copy->getType() == original->getType());
+      REQUIRE(copy->printShape() == original->printShape());
+      delete copy;
+    }
+  }
+
+  SECTION("Matches CanvasList") {
+    CanvasList list;
+    for (int i = 0; i < 50; i++) {
+      switch (i % 4) {
+        case 0: list.push_back(new Shape(i, i % 5)); break;
+        case 1: list.push_back(new Circle(-i, i, i)); break;
+        case 2: list.push_back(new Rect(i, -i, 2, i)); break;
+        default: list.push_back(new RightTriangle(i % 3, i, i, 4)); break;
+      }
+    }
+    ValueCanvas values(list);
+    REQUIRE(values.size() == list.size());
+
+    ostringstream fromList;
+    ostringstream fromValues;
+    list.draw(fromList);
+    values.draw(fromValues);
+    REQUIRE(fromValues.str() == fromList.str());
+    REQUIRE(values.find(4, 4) == list.find(4, 4));
+    REQUIRE(values.find(0, 3) == list.find(0, 3));
+    REQUIRE(values.find(1000, 0) == -1);
+
+    // makes sure the same edits leave both canvases equal
+    list.removeEveryOther();
+    values.removeEveryOther();
+    list.insertAfter(3, new Circle(1, 2, 3));
+    values.insertAfter(3, Circle(1, 2, 3));
+    list.push_front(new Rect(9, 9, 9, 9));
+    values.push_front(Rect(9, 9, 9, 9));
+    list.removeAt(10);
+    values.removeAt(10);
+    values.insertAfter(-1, Shape());
+    values.removeAt(values.size());
+
+    CanvasList rebuilt;
+    values.appendTo(rebuilt);
+    REQUIRE(rebuilt.size() == list.size());
+    for (int i = 0; i < list.size(); i++) {
+      REQUIRE(rebuilt.shapeAt(i)->printShape() == list.shapeAt(i)->printShape());
+    }
+  }
+
+  SECTION("Copies Are Independent") {
+    ValueCanvas original;
+    original.push_back(Circle(1, 1, 1));
+    original.push_back(Shape(2, 2));
+    ValueCanvas copy(original);
+
+    get<Circle>(*copy.shapeAt(0)).setRadius(10);
+    asShape(*copy.shapeAt(1)).setX(20);
+    REQUIRE(get<Circle>(*original.shapeAt(0)).getRadius() == 1);
+    REQUIRE(asShape(*original.shapeAt(1)).getX() == 2);
+
+    ShapeValue popped;
+    REQUIRE(copy.pop_front(popped) == true);
+    REQUIRE(get<Circle>(popped).getRadius() == 10);
+    REQUIRE(copy.pop_back(popped) == true);
+    REQUIRE(asShape(popped).getX() == 20);
+    REQUIRE(copy.pop_back(popped) == false);
+    REQUIRE(copy.isempty() == true);
+    REQUIRE(copy.shapeAt(0) == nullptr);
+    REQUIRE(original.size() == 2);
+  }
+}
+
+TEST_CASE("Column Canvas") {
+  CanvasList list;
+  for (int i = 0; i < 60; i++) {
+    switch (i % 5) {
+      case 0: list.push_back(new Shape(i, i % 4)); break;
+      case 1: list.push_back(new Circle(-i, i, i)); break;
+      case 2: list.push_back(new Rect(i, -i, 2, i)); break;
+      case 3: list.push_back(new Circle(i % 4, i % 4, 1)); break;
+      default: list.push_back(new RightTriangle(i % 3, i, i, 4)); break;
+    }
+  }
+  ColumnCanvas columns(list);
+
+  SECTION("Groups And Order") {
+    REQUIRE(columns.size() == 60);
+    REQUIRE(columns.count(SHAPE_BASIC) == 12);
+    REQUIRE(columns.count(SHAPE_CIRCLE) == 24);
+    REQUIRE(columns.count(SHAPE_RECT) == 12);
+    REQUIRE(columns.count(SHAPE_RIGHT_TRIANGLE) == 12);
+
+    // makes sure each group only keeps the columns its type uses
+    REQUIRE(columns.group(SHAPE_BASIC).a.empty());
+    REQUIRE(columns.group(SHAPE_CIRCLE).a.size() == 24);
+    REQUIRE(columns.group(SHAPE_CIRCLE).b.empty());
+    REQUIRE(columns.group(SHAPE_RECT).b.size() == 12);
+
+    // makes sure order and positions point at each other
+    for (int i = 0; i < columns.size(); i++) {
+      ShapeSlot slot = columns.slotAt(i);
+      REQUIRE(slot.type == list.shapeAt(i)->getType());
+      REQUIRE(columns.group(slot.type).position[slot.row] == i);
+      REQUIRE(columns.group(slot.type).x[slot.row] == list.shapeAt(i)->getX());
+    }
+  }
+
+  SECTION("Matches CanvasList") {
+    ostringstream fromList;
+    ostringstream fromColumns;
+    list.draw(fromList);
+    columns.draw(fromColumns);
+    REQUIRE(fromColumns.str() == fromList.str());
+
+    // makes sure find picks the earliest match across groups
+    REQUIRE(columns.find(0, 0) == list.find(0, 0));
+    REQUIRE(columns.find(3, 3) == list.find(3, 3));
+    REQUIRE(columns.find(-1, 1) == list.find(-1, 1));
+    REQUIRE(columns.find(500, 0) == -1);
+
+    CanvasList rebuilt;
+    columns.appendTo(rebuilt);
+    REQUIRE(rebuilt.size() == list.size());
+    for (int i = 0; i < list.size(); i++) {
+      REQUIRE(rebuilt.shapeAt(i)->printShape() == list.shapeAt(i)->printShape());
+    }
+
+    ShapeRecord record;
+    REQUIRE(columns.recordAt(-1, record) == false);
+    REQUIRE(columns.recordAt(60, record) == false);
+  }
+
+  SECTION("Push And Clear") {
+    ColumnCanvas canvas;
+    REQUIRE(canvas.isempty() == true);
+    REQUIRE(canvas.push_back(Rect(1, 2, 3, 4)) == true);
+    REQUIRE(canvas.push_back(ShapeRecord{SHAPE_CIRCLE, 5, 6, 7, 0}) == true);
+    REQUIRE(canvas.size() == 2);
+
+    // makes sure records with an unknown type are rejected and leave the canvas unchanged
+    REQUIRE(canvas.push_back(ShapeRecord{static_cast<ShapeType>(4), 1, 1, 1, 1}) == false);
+    REQUIRE(canvas.push_back(ShapeRecord{static_cast<ShapeType>(-1), 1, 1, 1, 1}) == false);
+    REQUIRE(canvas.size() == 2);
+    REQUIRE(canvas.find(5, 6) == 1);
+
+    ShapeRecord record;
+    REQUIRE(canvas.recordAt(0, record) == true);
+    REQUIRE(record.type == SHAPE_RECT);
+    REQUIRE(record.b == 4);
+
+    canvas.clear();
+    REQUIRE(canvas.isempty() == true);
+    REQUIRE(canvas.count(SHAPE_RECT) == 0);
+  }
+}
+
+TEST_CASE("Bulk Transform") {
+  // makes sure every kernel flavour gives exactly the scalar answer,
+  // including wraparound and the tails past the last full vector
+  SECTION("Kernels Agree") {
+    vector<int> input;
+    for (int i = 0; i < 37; i++) {
+      input.push_back(i * 7919 - 100000);
+    }
+    input.push_back(INT_MAX);
+    input.push_back(INT_MIN);
+    input.push_back(-1);
+
+    for (int32_t factor : {BulkTransform::ONE, BulkTransform::ONE / 2, 3 * BulkTransform::ONE,
+                           -BulkTransform::ONE, 12345, INT_MAX}) {
+      SimdLevel::limit(SIMD_SCALAR);
+      vector<int> expected = input;
+      BulkTransform::scaleInts(expected.data(), expected.size(), -5, factor);
+      vector<int> added = input;
+      BulkTransform::addInts(added.data(), added.size(), INT_MAX);
+
+      for (SimdKind kind : {SIMD_SSE41, SIMD_AVX2}) {
+        SimdLevel::limit(kind);
+        for (size_t count : {size_t(0), size_t(3), size_t(8), input.size()}) {
+          vector<int> scaled = input;
+          BulkTransform::scaleInts(scaled.data(), count, -5, factor);
+          for (size_t i = 0; i < input.size(); i++) {
+            REQUIRE(scaled[i] == (i < count ? expected[i] : input[i]));
+          }
+        }
+        vector<int> moved = input;
+        BulkTransform::addInts(moved.data(), moved.size(), INT_MAX);
+        REQUIRE(moved == added);
+      }
+    }
+    SimdLevel::limit(SIMD_AVX2);
+
+    int value = 7;
+    BulkTransform::scaleInts(&value, 1, 0, BulkTransform::ONE / 2);
+    REQUIRE(value == 3);
+    value = -7;
+    BulkTransform::scaleInts(&value, 1, 0, BulkTransform::ONE / 2);
+    REQUIRE(value == -4);
+  }
+
+  SECTION("Whole Canvas") {
+    ColumnCanvas canvas;
+    canvas.push_back(Shape(10, 20));
+    canvas.push_back(Circle(4, 6, 8));
+    canvas.push_back(Rect(-2, 2, 10, 4));
+    canvas.push_back(RightTriangle(0, 0, 6, 3));
+
+    BulkTransform::translate(canvas, 5, -5);
+    ostringstream moved;
+    canvas.draw(moved);
+    REQUIRE(moved.str() == "It's a Shape at x: 15, y: 15\n"
+                           "It's a Circle at x: 9, y: 1, radius: 8\n"
+                           "It's a Rectangle at x: 3, y: -3 with width: 10 and height: 4\n"
+                           "It's a Right Triangle at x: 5, y: -5 with base: 6 and height: 3\n");
+
+    // makes sure origins move relative to the point and sizes just scale
+    BulkTransform::scale(canvas, 5, -5, 2 * BulkTransform::ONE);
+    ostringstream scaled;
+    canvas.draw(scaled);
+    REQUIRE(scaled.str() == "It's a Shape at x: 25, y: 35\n"
+                            "It's a Circle at x: 13, y: 7, radius: 16\n"
+                            "It's a Rectangle at x: 1, y: -1 with width: 20 and height: 8\n"
+                            "It's a Right Triangle at x: 5, y: -5 with base: 12 and height: 6\n");
+  }
+
+  SECTION("Level Control") {
+    REQUIRE(SimdLevel::active() == SimdLevel::detected());
+    SimdLevel::limit(SIMD_SCALAR);
+    REQUIRE(SimdLevel::active() == SIMD_SCALAR);
+    SimdLevel::limit(SIMD_AVX2);
+    REQUIRE(SimdLevel::active() == SimdLevel::detected());
+    REQUIRE(string(SimdLevel::name(SIMD_SSE41)) == "sse4.1");
+  }
+}
+
+TEST_CASE("Area Perimeter And Canvas Stats") {
+  SECTION("Single Shapes") {
+    REQUIRE(Shape(3, 4).getArea() == 0);
+    REQUIRE(Shape(3, 4).getPerimeter() == 0);
+    REQUIRE(Rect(0, 0, 3, 4).getArea() == 12);
+    REQUIRE(Rect(0, 0, -3, 4).getArea() == 12);
+    REQUIRE(Rect(0, 0, -3, 4).getPerimeter() == 14);
+    REQUIRE(Circle(0, 0, 2).getArea() == Approx(12.566370614));
+    REQUIRE(Circle(0, 0, -2).getPerimeter() == Approx(12.566370614));
+    REQUIRE(RightTriangle(0, 0, 3, -4).getArea() == 6);
+    REQUIRE(RightTriangle(0, 0, 3, -4).getPerimeter() == 12);
+
+    // makes sure the virtual functions are used through a base pointer
+    Shape *shape = new Rect(1, 1, 100000, 100000);
+    REQUIRE(shape->getArea() == 1e10);
+    delete shape;
+  }
+
+  CanvasList list;
+  for (int i = 0; i < 103; i++) {
+    switch (i % 4) {
+      case 0: list.push_back(new Shape(i * 3, -i)); break;
+      case 1: list.push_back(new Circle(-i, i, i % 2 == 0 ? i : -i)); break;
+      case 2: list.push_back(new Rect(i, -i, i - 50, i + 1)); break;
+      default: list.push_back(new RightTriangle(i % 3, i, -i, 4)); break;
+    }
+  }
+  ColumnCanvas columns(list);
+
+  SECTION("Matches Per Shape Totals") {
+    CanvasSummary expected = CanvasStats::summarize(list);
+    double area = 0;
+    double perimeter = 0;
+    for (int i = 0; i < list.size(); i++) {
+      area += list.shapeAt(i)->getArea();
+      perimeter += list.shapeAt(i)->getPerimeter();
+    }
+    REQUIRE(expected.count == 103);
+    REQUIRE(expected.area == Approx(area));
+    REQUIRE(expected.perimeter == Approx(perimeter));
+    REQUIRE(expected.types[SHAPE_BASIC].count == 26);
+    REQUIRE(expected.types[SHAPE_BASIC].area == 0);
+
+    // makes sure every kernel flavour gives the same summary
+    for (SimdKind kind : {SIMD_SCALAR, SIMD_SSE41, SIMD_AVX2}) {
+      SimdLevel::limit(kind);
+      CanvasSummary summary = CanvasStats::summarize(columns);
+      REQUIRE(summary.count == expected.count);
+      REQUIRE(summary.area == Approx(expected.area));
+      REQUIRE(summary.perimeter == Approx(expected.perimeter));
+      for (int type = 0; type < 4; type++) {
+        REQUIRE(summary.types[type].count == expected.types[type].count);
+        REQUIRE(summary.types[type].area == Approx(expected.types[type].area));
+        REQUIRE(summary.types[type].perimeter == Approx(expected.types[type].perimeter));
+        for (int bucket = 0; bucket < TypeSummary::AREA_BUCKETS; bucket++) {
+          REQUIRE(summary.types[type].areaBuckets[bucket] == expected.types[type].areaBuckets[bucket]);
+        }
+      }
+      REQUIRE(summary.bounds.minX == expected.bounds.minX);
+      REQUIRE(summary.bounds.minY == expected.bounds.minY);
+      REQUIRE(summary.bounds.maxX == expected.bounds.maxX);
+      REQUIRE(summary.bounds.maxY == expected.bounds.maxY);
+    }
+    SimdLevel::limit(SIMD_AVX2);
+  }
+
+  SECTION("Area Histograms") {
+    // makes sure buckets double in width and the last one takes the rest
+    REQUIRE(CanvasStats::areaBucket(0) == 0);
+    REQUIRE(CanvasStats::areaBucket(0.99) == 0);
+    REQUIRE(CanvasStats::areaBucket(1) == 1);
+    REQUIRE(CanvasStats::areaBucket(6) == 3);
+    REQUIRE(CanvasStats::areaBucket(8) == 4);
+    REQUIRE(CanvasStats::areaBucket(1e30) == TypeSummary::AREA_BUCKETS - 1);
+
+    // makes sure every shape lands in the bucket of its own area
+    CanvasSummary summary = CanvasStats::summarize(list);
+    for (int type = 0; type < 4; type++) {
+      long total = 0;
+      for (long count : summary.types[type].areaBuckets) {
+        total += count;
+      }
+      REQUIRE(total == summary.types[type].count);
+    }
+    long expected[4][TypeSummary::AREA_BUCKETS] = {};
+    for (int i = 0; i < list.size(); i++) {
+      Shape *shape = list.shapeAt(i);
+      expected[shape->getType()][CanvasStats::areaBucket(shape->getArea())]++;
+    }
+    for (int type = 0; type < 4; type++) {
+      for (int bucket = 0; bucket < TypeSummary::AREA_BUCKETS; bucket++) {
+        REQUIRE(summary.types[type].areaBuckets[bucket] == expected[type][bucket]);
+      }
+    }
+    REQUIRE(summary.types[SHAPE_BASIC].areaBuckets[0] == 26);
+  }
+
+  SECTION("Extreme Radius") {
+    // makes sure every kernel flavour wraps an INT_MIN radius the same way
+    ColumnCanvas extremes;
+    for (int i = 0; i < 11; i++) {
+      extremes.push_back(Circle(i * 5, -i, i == 3 || i == 10 ? INT_MIN : i));
+    }
+    SimdLevel::limit(SIMD_SCALAR);
+    CanvasSummary scalar = CanvasStats::summarize(extremes);
+    for (SimdKind kind : {SIMD_SSE41, SIMD_AVX2}) {
+      SimdLevel::limit(kind);
+      CanvasSummary summary = CanvasStats::summarize(extremes);
+      REQUIRE(summary.bounds.minX == scalar.bounds.minX);
+      REQUIRE(summary.bounds.minY == scalar.bounds.minY);
+      REQUIRE(summary.bounds.maxX == scalar.bounds.maxX);
+      REQUIRE(summary.bounds.maxY == scalar.bounds.maxY);
+    }
+    SimdLevel::limit(SIMD_AVX2);
+  }
+
+  SECTION("Empty Canvas") {
+    CanvasSummary summary = CanvasStats::summarize(ColumnCanvas());
+    REQUIRE(summary.count == 0);
+    REQUIRE(summary.area == 0);
+    REQUIRE(summary.bounds.minX == 0);
+    REQUIRE(summary.bounds.maxY == 0);
+  }
+}
+
+TEST_CASE("Copy On Write Canvas") {
+  const int n = CowCanvas::CHUNK_SHAPES * 4 + 10;
+  CowCanvas original;
+  for (int i = 0; i < n; i++) {
+    original.push_back(new Circle(i, i % 7, 1));
+  }
+  REQUIRE(original.size() == n);
+  REQUIRE(original.chunkCount() == 5);
+
+  SECTION("Copies Share Shapes") {
+    CowCanvas copy(original);
+    CowCanvas assigned;
+    assigned = original;
+
+    // makes sure nothing was cloned by copying
+    for (int i = 0; i < n; i++) {
+      REQUIRE(copy.shapeAt(i) == original.shapeAt(i));
+      REQUIRE(assigned.shapeAt(i) == original.shapeAt(i));
+    }
+  }
+
+  SECTION("Edits Are Isolated") {
+    CowCanvas copy(original);
+    copy.editAt(300)->setX(-5);
+    REQUIRE(copy.shapeAt(300)->getX() == -5);
+    REQUIRE(original.shapeAt(300)->getX() == 300);
+
+    // makes sure only the edited chunk was cloned
+    int cloned = 0;
+    for (int i = 0; i < n; i++) {
+      if (copy.shapeAt(i) != original.shapeAt(i)) {
+        cloned++;
+      }
+    }
+    REQUIRE(cloned == CowCanvas::CHUNK_SHAPES);
+
+    copy.push_back(new Rect(1, 2, 3, 4));
+    copy.push_front(new Shape(9, 9));
+    copy.insertAfter(500, new Shape(8, 8));
+    copy.removeAt(2);
+    REQUIRE(copy.size() == n + 2);
+    REQUIRE(original.size() == n);
+    REQUIRE(copy.find(9, 9) == 0);
+    REQUIRE(copy.find(8, 8) == 500);
+    REQUIRE(original.find(9, 9) == -1);
+    REQUIRE(original.shapeAt(n - 1)->getX() == n - 1);
+  }
+
+  SECTION("Pops And Removals") {
+    CowCanvas copy(original);
+    Shape *front = copy.pop_front();
+    Shape *back = copy.pop_back();
+    REQUIRE(front->getX() == 0);
+    REQUIRE(back->getX() == n - 1);
+
+    // makes sure popped shapes from a shared chunk are the caller's own copies
+    REQUIRE(front != original.shapeAt(0));
+    REQUIRE(back != original.shapeAt(n - 1));
+    delete front;
+    delete back;
+
+    copy.removeEveryOther();
+    REQUIRE(copy.size() == (n - 1) / 2);
+    for (int i = 0; i < copy.size(); i++) {
+      REQUIRE(copy.shapeAt(i)->getX() == 1 + 2 * i);
+    }
+    REQUIRE(original.size() == n);
+    REQUIRE(original.shapeAt(1)->getX() == 1);
+
+    // makes sure an unshared canvas matches CanvasList
+    CanvasList list;
+    CowCanvas alone;
+    for (int i = 0; i < 600; i++) {
+      list.push_back(new Shape(i, 0));
+      alone.push_back(new Shape(i, 0));
+    }
+    for (int i = 0; i < 300; i++) {
+      list.insertAfter(i * 2, new Rect(i, 1, 1, 1));
+      alone.insertAfter(i * 2, new Rect(i, 1, 1, 1));
+    }
+    list.removeEveryOther();
+    alone.removeEveryOther();
+    delete list.pop_back();
+    delete alone.pop_back();
+    ostringstream fromList;
+    ostringstream fromCow;
+    list.draw(fromList);
+    alone.draw(fromCow);
+    REQUIRE(fromCow.str() == fromList.str());
+
+    alone.clear();
+    REQUIRE(alone.isempty() == true);
+    REQUIRE(alone.pop_front() == nullptr);
+    REQUIRE(alone.shapeAt(0) == nullptr);
+    REQUIRE(alone.editAt(0) == nullptr);
+  }
+
+  SECTION("Conversion From CanvasList") {
+    CanvasList list;
+    list.push_back(new Circle(1, 2, 3));
+    list.push_back(new RightTriangle(4, 5, 6, 7));
+    CowCanvas cow(list);
+    REQUIRE(cow.size() == 2);
+    REQUIRE(cow.shapeAt(1)->printShape() == list.shapeAt(1)->printShape());
+    REQUIRE(cow.shapeAt(1) != list.shapeAt(1));
+  }
+}
+
+TEST_CASE("Persistent Canvas") {
+  SECTION("Matches CanvasList") {
+    CanvasList list;
+    PersistentCanvas canvas;
+    for (int i = 0; i < 500; i++) {
+      if (i % 3 == 0) {
+        list.push_front(new Shape(i, 0));
+        canvas.push_front(new Shape(i, 0));
+      }
+      else {
+        list.push_back(new Circle(i, 1, i));
+        canvas.push_back(new Circle(i, 1, i));
+      }
+    }
+    for (int i = 0; i < 200; i++) {
+      int idx = (i * 37) % list.size();
+      list.insertAfter(idx, new Rect(i, 2, 3, 4));
+      canvas.insertAfter(idx, new Rect(i, 2, 3, 4));
+      list.removeAt((i * 53) % list.size());
+      canvas.removeAt((i * 53) % canvas.size());
+    }
+    // makes sure out of range calls do nothing; the caller keeps the shape
+    Shape *unused = new Shape();
+    canvas.insertAfter(-1, unused);
+    delete unused;
+    canvas.removeAt(canvas.size());
+    REQUIRE(canvas.size() == list.size());
+
+    ostringstream fromList;
+    ostringstream fromTree;
+    list.draw(fromList);
+    canvas.draw(fromTree);
+    REQUIRE(fromTree.str() == fromList.str());
+    REQUIRE(canvas.find(42, 1) == list.find(42, 1));
+    REQUIRE(canvas.find(-1, -1) == -1);
+
+    // makes sure the tree stays balanced, within 1.44 log2 of the size
+    REQUIRE(canvas.height() <= 14);
+
+    list.removeEveryOther();
+    canvas.removeEveryOther();
+    Shape *fromListFront = list.pop_front();
+    Shape *fromTreeFront = canvas.pop_front();
+    Shape *fromListBack = list.pop_back();
+    Shape *fromTreeBack = canvas.pop_back();
+    REQUIRE(fromTreeFront->printShape() == fromListFront->printShape());
+    REQUIRE(fromTreeBack->printShape() == fromListBack->printShape());
+    delete fromListFront;
+    delete fromTreeFront;
+    delete fromListBack;
+    delete fromTreeBack;
+    for (int i = 0; i < list.size(); i++) {
+      REQUIRE(canvas.shapeAt(i)->printShape() == list.shapeAt(i)->printShape());
+    }
+  }
+
+  SECTION("Versions Share Structure") {
+    PersistentCanvas first;
+    for (int i = 0; i < 1000; i++) {
+      first.push_back(new Shape(i, i));
+    }
+    PersistentCanvas second = first;
+    second.replaceAt(10, new Circle(0, 0, 5));
+    second.removeAt(999);
+    PersistentCanvas third = second;
+    third.push_front(new Rect(1, 1, 1, 1));
+
+    // makes sure every older version still reads as it was
+    REQUIRE(first.size() == 1000);
+    REQUIRE(first.shapeAt(10)->getType() == SHAPE_BASIC);
+    REQUIRE(first.shapeAt(999)->getX() == 999);
+    REQUIRE(second.size() == 999);
+    REQUIRE(second.shapeAt(10)->getType() == SHAPE_CIRCLE);
+    REQUIRE(third.size() == 1000);
+    REQUIRE(third.shapeAt(11)->getType() == SHAPE_CIRCLE);
+    REQUIRE(third.shapeAt(0)->getType() == SHAPE_RECT);
+
+    // makes sure unchanged shapes are the same objects in every version
+    for (int i = 0; i < 999; i++) {
+      if (i != 10) {
+        REQUIRE(second.shapeAt(i) == first.shapeAt(i));
+        REQUIRE(third.shapeAt(i + 1) == first.shapeAt(i));
+      }
+    }
+
+    second.clear();
+    REQUIRE(second.isempty() == true);
+    REQUIRE(second.pop_back() == nullptr);
+    REQUIRE(second.shapeAt(0) == nullptr);
+    REQUIRE(third.shapeAt(11)->getType() == SHAPE_CIRCLE);
+  }
+
+  SECTION("Conversion From CanvasList") {
+    CanvasList list;
+    for (int i = 0; i < 100; i++) {
+      list.push_back(new RightTriangle(i, -i, 2, 3));
+    }
+    PersistentCanvas canvas(list);
+    REQUIRE(canvas.size() == 100);
+    REQUIRE(canvas.height() == 7);
+    REQUIRE(canvas.shapeAt(99)->printShape() == list.shapeAt(99)->printShape());
+    REQUIRE(canvas.shapeAt(99) != list.shapeAt(99));
+  }
+}
+
+TEST_CASE("Concurrent Canvas") {
+  SECTION("Matches CanvasList") {
+    CanvasList list;
+    ConcurrentCanvas canvas;
+    REQUIRE(canvas.isempty() == true);
+    for (int i = 0; i < 300; i++) {
+      list.push_back(new Rect(i, 0, 1, 2));
+      canvas.push_back(new Rect(i, 0, 1, 2));
+      if (i % 4 == 0) {
+        list.push_front(new Circle(i, 1, 3));
+        canvas.push_front(new Circle(i, 1, 3));
+      }
+      if (i % 3 == 0) {
+        list.removeAt((i * 7) % list.size());
+        canvas.removeAt((i * 7) % canvas.size());
+      }
+      if (i % 5 == 0) {
+        list.insertAfter(i % list.size(), new Shape(i, 2));
+        canvas.insertAfter(i % canvas.size(), new Shape(i, 2));
+      }
+    }
+    // makes sure removing the tail keeps push_back appending in the right place
+    list.removeAt(list.size() - 1);
+    canvas.removeAt(canvas.size() - 1);
+    list.push_back(new Shape(-1, -1));
+    canvas.push_back(new Shape(-1, -1));
+    canvas.removeAt(-1);
+    Shape *unused = new Shape();
+    canvas.insertAfter(canvas.size(), unused);
+    delete unused;
+
+    REQUIRE(canvas.size() == list.size());
+    ostringstream fromList;
+    ostringstream fromCanvas;
+    list.draw(fromList);
+    canvas.draw(fromCanvas);
+    REQUIRE(fromCanvas.str() == fromList.str());
+    REQUIRE(canvas.find(20, 1) == list.find(20, 1));
+    REQUIRE(canvas.find(-1, -1) == list.size() - 1);
+
+    ShapeRecord record;
+    REQUIRE(canvas.shapeAt(0, record) == true);
+    REQUIRE(record.type == list.shapeAt(0)->getType());
+    REQUIRE(canvas.shapeAt(canvas.size(), record) == false);
+    REQUIRE(canvas.shapeAt(-1, record) == false);
+
+    canvas.clear();
+    REQUIRE(canvas.isempty() == true);
+    canvas.push_back(new Shape(5, 5));
+    REQUIRE(canvas.find(5, 5) == 0);
+  }
+
+  // makes sure readers on several threads only ever see whole shapes
+  // while a writer inserts and removes; run tests_tsan.exe from
+  // make testtsan to check this under ThreadSanitizer
+  SECTION("Readers During Writes") {
+    ConcurrentCanvas canvas;
+    for (int i = 0; i < 200; i++) {
+      canvas.push_back(new Circle(i, i, i));
+    }
+
+    atomic<bool> done(false);
+    atomic<long> badReads(0);
+    atomic<long> reads(0);
+    vector<thread> readers;
+    for (int r = 0; r < 3; r++) {
+      readers.emplace_back([&, r] {
+        ShapeRecord record;
+        while (!done.load()) {
+          int size = canvas.size();
+          if (canvas.shapeAt((r * 31 + reads.load()) % (size + 1), record)) {
+            if (record.type != SHAPE_CIRCLE || record.x != record.y || record.y != record.a) {
+              badReads++;
+            }
+          }
+          canvas.find(r, r);
+          if (r == 0) {
+            ostringstream out;
+            canvas.draw(out);
+            string text = out.str();
+            if (!text.empty() && text.back() != '\n') {
+              badReads++;
+            }
+          }
+          reads++;
+        }
+      });
+    }
+
+    for (int i = 0; i < 5000; i++) {
+      canvas.push_back(new Circle(i, i, i));
+      canvas.insertAfter(i % canvas.size(), new Circle(-i, -i, -i));
+      canvas.removeAt((i * 13) % canvas.size());
+      canvas.removeAt(0);
+    }
+    done = true;
+    for (thread &t : readers) {
+      t.join();
+    }
+
+    REQUIRE(badReads.load() == 0);
+    REQUIRE(reads.load() > 0);
+    REQUIRE(canvas.size() == 200);
+
+    // makes sure retired nodes are freed as the writer goes
+    REQUIRE(canvas.pendingReclaim() < 10000);
+  }
+}
+
+TEST_CASE("Lock Free Ingest Stack") {
+  SECTION("Matches CanvasList push_front") {
+    IngestStack stack;
+    CanvasList expected;
+    CanvasList list;
+    REQUIRE(stack.isempty() == true);
+    REQUIRE(stack.pop_front() == nullptr);
+
+    expected.push_back(new Shape(0, 0));
+    list.push_back(new Shape(0, 0));
+    for (int i = 1; i <= 10; i++) {
+      stack.push_front(new Circle(i, i, i));
+      expected.push_front(new Circle(i, i, i));
+    }
+    REQUIRE(stack.size() == 10);
+
+    Shape *top = stack.pop_front();
+    REQUIRE(top->getX() == 10);
+    delete top;
+    delete expected.pop_front();
+
+    // makes sure moveInto leaves the list as direct push_front calls would
+    REQUIRE(stack.moveInto(list) == 9);
+    REQUIRE(stack.isempty() == true);
+    REQUIRE(stack.size() == 0);
+    ostringstream fromExpected;
+    ostringstream fromList;
+    expected.draw(fromExpected);
+    list.draw(fromList);
+    REQUIRE(fromList.str() == fromExpected.str());
+  }
+
+  // makes sure no push is lost or duplicated when producers and
+  // consumers race; make testtsan checks this under ThreadSanitizer
+  SECTION("Producers And Consumers") {
+    IngestStack stack;
+    const int producers = 4;
+    const int each = 5000;
+    atomic<int> producing(producers);
+    atomic<long> popped(0);
+    atomic<long> poppedSum(0);
+
+    vector<thread> threads;
+    for (int p = 0; p < producers; p++) {
+      threads.emplace_back([&, p] {
+        for (int i = 0; i < each; i++) {
+          stack.push_front(new Shape(p * each + i, 0));
+        }
+        producing--;
+      });
+    }
+    for (int c = 0; c < 2; c++) {
+      threads.emplace_back([&] {
+        while (producing.load() > 0 || !stack.isempty()) {
+          Shape *shape = stack.pop_front();
+          if (shape != nullptr) {
+            popped++;
+            poppedSum += shape->getX();
+            delete shape;
+          }
+        }
+      });
+    }
+    for (thread &t : threads) {
+      t.join();
+    }
+
+    long total = producers * each;
+    REQUIRE(popped.load() == total);
+    REQUIRE(poppedSum.load() == total * (total - 1) / 2);
+    REQUIRE(stack.size() == 0);
+  }
+}
+
+TEST_CASE("Sharded Canvas") {
+  ThreadPool pool(3);
+
+  SECTION("Routing And Find") {
+    ShardedCanvas canvas(pool, 8);
+    CanvasList list;
+    for (int i = 0; i < 400; i++) {
+      canvas.push_back(new Circle(i % 50, i % 7, i));
+      list.push_back(new Circle(i % 50, i % 7, i));
+    }
+    REQUIRE(canvas.size() == 400);
+    REQUIRE(canvas.shardCount() == 8);
+
+    // makes sure every shard got some shapes and the sizes add up
+    vector<int> sizes = canvas.shardSizes();
+    int total = 0;
+    for (int shardSize : sizes) {
+      REQUIRE(shardSize > 0);
+      total += shardSize;
+    }
+    REQUIRE(total == 400);
+
+    // makes sure find returns the first shape added at the point
+    for (int i = 0; i < 60; i++) {
+      int x = i % 50;
+      int y = i % 7;
+      ShardRef ref = canvas.find(x, y);
+      int expected = list.find(x, y);
+      if (expected < 0) {
+        REQUIRE(ref.shard == -1);
+      }
+      else {
+        REQUIRE(ref.shard == canvas.shardOf(x, y));
+        int radius = -1;
+        REQUIRE(canvas.withShape(ref, [&](const Shape &shape) { radius = static_cast<const Circle &>(shape).getRadius(); }));
+        REQUIRE(radius == static_cast<Circle *>(list.shapeAt(expected))->getRadius());
+      }
+    }
+
+    canvas.enableFindIndex();
+    ShardRef ref = canvas.find(3, 3);
+    REQUIRE(ref.shard >= 0);
+    canvas.removeAt(ref);
+    REQUIRE(canvas.size() == 399);
+    // makes sure bad refs never reach the reader
+    auto reader = [](const Shape &) { FAIL("reader called"); };
+    REQUIRE(canvas.withShape(ShardRef{-1, -1}, reader) == false);
+    REQUIRE(canvas.withShape(ShardRef{0, 100000}, reader) == false);
+    canvas.removeAt(ShardRef{99, 0});
+    REQUIRE(canvas.size() == 399);
+  }
+
+  SECTION("Parallel Fan Out") {
+    ShardedCanvas canvas(pool, 5, 16);
+    for (int i = 0; i < 300; i++) {
+      if (i % 3 == 0) {
+        canvas.push_back(new Rect(i, -i, 2, 2));
+      }
+      else {
+        canvas.push_back(new Shape(i, -i));
+      }
+    }
+    REQUIRE(canvas.countIf([](const Shape &shape) { return shape.getType() == SHAPE_RECT; }) == 100);
+
+    // makes sure nearby points share a shard when routing by cell
+    REQUIRE(canvas.shardOf(0, 0) == canvas.shardOf(15, 15));
+    REQUIRE(canvas.shardOf(-1, -1) == canvas.shardOf(-16, -16));
+
+    // makes sure draw writes every shard in order, each in its own order
+    ostringstream out;
+    canvas.draw(out);
+    string expected;
+    for (int shard = 0; shard < canvas.shardCount(); shard++) {
+      for (int i = 0; i < 300; i++) {
+        if (canvas.shardOf(i, -i) == shard) {
+          expected += (i % 3 == 0 ? Rect(i, -i, 2, 2).printShape() : Shape(i, -i).printShape()) + "\n";
+        }
+      }
+    }
+    REQUIRE(out.str() == expected);
+
+    canvas.clear();
+    REQUIRE(canvas.isempty() == true);
+  }
+}
+
+TEST_CASE("Parallel Copy") {
+  ThreadPool pool(4);
+
+  CanvasList source;
+  source.enableFindIndex();
+  source.enableSpatialIndex(8);
+  for (int i = 0; i < 1000; i++) {
+    if (i % 2 == 0) {
+      source.push_back(new Circle(i % 37, i % 11, i));
+    }
+    else {
+      source.push_back(new Rect(i % 37, i % 11, i, i + 1));
+    }
+  }
+
+  SECTION("Copy Constructor") {
+    CanvasList copy(source, pool, 100);
+    REQUIRE(copy.size() == 1000);
+    REQUIRE(copy.hasFindIndex() == true);
+    REQUIRE(copy.hasSpatialIndex() == true);
+
+    // makes sure the copy keeps the order, owns new shapes and links both ways
+    ShapeNode *origNode = source.front();
+    ShapeNode *copyNode = copy.front();
+    ShapeNode *prevNode = nullptr;
+    while (origNode != nullptr) {
+      REQUIRE(copyNode != nullptr);
+      REQUIRE(copyNode->value != origNode->value);
+      REQUIRE(copyNode->prev == prevNode);
+      REQUIRE(copyNode->value->printShape() == origNode->value->printShape());
+      prevNode = copyNode;
+      origNode = origNode->next;
+      copyNode = copyNode->next;
+    }
+    REQUIRE(copyNode == nullptr);
+    REQUIRE(copy.back() == prevNode);
+
+    // makes sure the indexes and positions of the copy answer like the source
+    for (int x = 0; x < 37; x++) {
+      REQUIRE(copy.find(x, x % 11) == source.find(x, x % 11));
+    }
+    REQUIRE(copy.shapesAt(5, 5) == source.shapesAt(5, 5));
+    REQUIRE(copy.shapeAt(999) == copy.back()->value);
+
+    // makes sure the copied shapes report moves to their new list
+    copy.shapeAt(0)->setX(500);
+    REQUIRE(copy.find(500, 0) == 0);
+    REQUIRE(source.find(500, 0) == -1);
+  }
+
+  SECTION("Assignment Operator") {
+    CanvasList target;
+    target.push_back(new Shape(1, 1));
+    REQUIRE(&target.assignFrom(source, pool, 100) == &target);
+    REQUIRE(target.size() == 1000);
+    REQUIRE(target.shapeAt(0)->printShape() == source.shapeAt(0)->printShape());
+    REQUIRE(target.shapeAt(999)->printShape() == source.shapeAt(999)->printShape());
+
+    // makes sure the copy can grow at both ends afterwards
+    target.push_back(new Shape(2, 2));
+    target.push_front(new Shape(3, 3));
+    REQUIRE(target.size() == 1002);
+    REQUIRE(target.back()->prev->value->printShape() == source.back()->value->printShape());
+    target.removeEveryOther();
+    REQUIRE(target.size() == 501);
+  }
+
+  SECTION("Shared Pool") {
+    // makes sure plain copies of lists past the threshold keep every shape
+    // in order, whether or not this machine has cores for the shared pool
+    CanvasList large;
+    large.enableFindIndex();
+    for (int i = 0; i < CanvasList::PARALLEL_COPY_MIN + 5; i++) {
+      large.push_back(new Rect(i, i % 13, 1, 2));
+    }
+    CanvasList copy(large);
+    CanvasList assigned;
+    assigned = large;
+    REQUIRE(copy.size() == large.size());
+    REQUIRE(assigned.size() == large.size());
+    ShapeNode *origNode = large.front();
+    ShapeNode *copyNode = copy.front();
+    ShapeNode *assignedNode = assigned.front();
+    bool same = true;
+    while (origNode != nullptr) {
+      same = same && copyNode->value != origNode->value &&
+             copyNode->value->getX() == origNode->value->getX() &&
+             assignedNode->value->getX() == origNode->value->getX();
+      origNode = origNode->next;
+      copyNode = copyNode->next;
+      assignedNode = assignedNode->next;
+    }
+    REQUIRE(same == true);
+    REQUIRE(copy.find(CanvasList::PARALLEL_COPY_MIN, CanvasList::PARALLEL_COPY_MIN % 13) == CanvasList::PARALLEL_COPY_MIN);
+  }
+
+  SECTION("Below Threshold") {
+    // makes sure small lists and one-worker pools still copy serially
+    CanvasList small(source, pool, 5000);
+    REQUIRE(small.size() == 1000);
+    REQUIRE(small.shapeAt(500)->printShape() == source.shapeAt(500)->printShape());
+    ThreadPool single(1);
+    CanvasList serial(source, single, 0);
+    REQUIRE(serial.shapeAt(500)->printShape() == source.shapeAt(500)->printShape());
+    CanvasList empty;
+    CanvasList emptyCopy(empty, pool, 0);
+    REQUIRE(emptyCopy.isempty() == true);
+    REQUIRE(serial.assignFrom(empty, pool, 0).isempty() == true);
+  }
+}
+
+TEST_CASE("Canvas Search") {
+  ThreadPool pool(3);
+  CanvasSearch search(pool, 16);
+
+  CanvasList list;
+  for (int i = 0; i < 2000; i++) {
+    switch (i % 4) {
+      case 0: list.push_back(new Shape(i, i % 100)); break;
+      case 1: list.push_back(new Circle(i, i % 100, i % 10)); break;
+      case 2: list.push_back(new Rect(i, i % 100, i % 20, 3)); break;
+      default: list.push_back(new RightTriangle(i, i % 100, 4, i % 8)); break;
+    }
+  }
+
+  SECTION("Shape Filter") {
+    ShapeFilter any;
+    REQUIRE(any(Shape(5, 5)) == true);
+    REQUIRE(any(Circle(-5, 5, 2)) == true);
+
+    // makes sure each part of the filter can reject a shape on its own
+    ShapeFilter filter;
+    filter.types = ShapeFilter::typeBit(SHAPE_RECT) | ShapeFilter::typeBit(SHAPE_CIRCLE);
+    REQUIRE(filter(Shape(1, 1)) == false);
+    REQUIRE(filter(Rect(1, 1, 2, 2)) == true);
+    filter.minX = 0;
+    filter.maxY = 10;
+    REQUIRE(filter(Rect(-1, 1, 2, 2)) == false);
+    REQUIRE(filter(Rect(1, 11, 2, 2)) == false);
+    filter.minArea = 5.0;
+    filter.maxArea = 10.0;
+    REQUIRE(filter(Rect(1, 1, 2, 2)) == false);
+    REQUIRE(filter(Rect(1, 1, 2, 3)) == true);
+    REQUIRE(filter(Rect(1, 1, 4, 3)) == false);
+  }
+
+  SECTION("Matches Serial Scan") {
+    ShapeFilter filter;
+    filter.types = ShapeFilter::typeBit(SHAPE_RECT);
+    filter.minY = 40;
+    filter.maxY = 60;
+    filter.minArea = 30.0;
+
+    // makes sure every query gives the same answer as walking the list
+    vector<int> expected;
+    int idx = 0;
+    for (ShapeNode *curr = list.front(); curr != nullptr; curr = curr->next) {
+      if (filter(*curr->value)) {
+        expected.push_back(idx);
+      }
+      idx++;
+    }
+    REQUIRE(expected.empty() == false);
+    REQUIRE(search.findAll(list, filter) == expected);
+    REQUIRE(search.count(list, filter) == static_cast<long>(expected.size()));
+    REQUIRE(search.findFirst(list, filter) == expected.front());
+
+    // makes sure the first match is found even in the last range
+    auto last = [](const Shape &shape) { return shape.getX() == 1999; };
+    REQUIRE(search.findFirst(list, last) == 1999);
+    REQUIRE(search.findFirst(list, [](const Shape &shape) { return shape.getX() < 0; }) == -1);
+    REQUIRE(search.count(list, [](const Shape &) { return true; }) == 2000);
+  }
+
+  SECTION("Exact Point Like Find") {
+    // makes sure a point predicate keeps find's first match semantics
+    list.push_back(new Circle(7, 7, 1));
+    auto at = [](int x, int y) {
+      return [x, y](const Shape &shape) { return shape.getX() == x && shape.getY() == y; };
+    };
+    REQUIRE(search.findFirst(list, at(7, 7)) == list.find(7, 7));
+    REQUIRE(search.findFirst(list, at(1500, 0)) == list.find(1500, 0));
+    REQUIRE(search.findFirst(list, at(3, 4)) == list.find(3, 4));
+  }
+
+  SECTION("Small And Empty Lists") {
+    CanvasList empty;
+    REQUIRE(search.findFirst(empty, ShapeFilter()) == -1);
+    REQUIRE(search.findAll(empty, ShapeFilter()).empty() == true);
+    REQUIRE(search.count(empty, ShapeFilter()) == 0);
+
+    // makes sure a list of one range is scanned without the pool
+    CanvasSearch wide(pool, 100000);
+    REQUIRE(wide.findAll(list, ShapeFilter()).size() == 2000);
+    REQUIRE(wide.findFirst(list, [](const Shape &shape) { return shape.getType() == SHAPE_RIGHT_TRIANGLE; }) == 3);
+  }
+}
+
+TEST_CASE("Bulk Removal") {
+  CanvasList list;
+  list.enableFindIndex();
+  for (int i = 0; i < 3000; i++) {
+    if (i % 3 == 0) {
+      list.push_back(new Circle(i, i % 10, i % 7));
+    }
+    else {
+      list.push_back(new Shape(i, i % 10));
+    }
+  }
+
+  SECTION("Remove If") {
+    // makes sure every match goes and the rest keep their order
+    int removed = list.removeIf([](const Shape &shape) { return shape.getType() == SHAPE_CIRCLE; });
+    REQUIRE(removed == 1000);
+    REQUIRE(list.size() == 2000);
+    int prevX = -1;
+    ShapeNode *prevNode = nullptr;
+    for (ShapeNode *curr = list.front(); curr != nullptr; curr = curr->next) {
+      REQUIRE(curr->value->getType() == SHAPE_BASIC);
+      REQUIRE(curr->value->getX() > prevX);
+      REQUIRE(curr->prev == prevNode);
+      prevX = curr->value->getX();
+      prevNode = curr;
+    }
+    REQUIRE(list.back() == prevNode);
+
+    // makes sure the index and positions still give the right index
+    REQUIRE(list.find(1, 1) == 0);
+    REQUIRE(list.find(2999, 9) == 1999);
+    REQUIRE(list.find(3, 3) == -1);
+
+    REQUIRE(list.removeIf([](const Shape &) { return false; }) == 0);
+    REQUIRE(list.removeIf([](const Shape &) { return true; }) == 2000);
+    REQUIRE(list.isempty() == true);
+    REQUIRE(list.front() == nullptr);
+    REQUIRE(list.back() == nullptr);
+  }
+
+  SECTION("Remove Indices") {
+    // makes sure repeats, negatives and out of range indices are ignored
+    vector<int> indices = {-4, 0, 1, 1, 500, 1500, 2999, 3000, 7000};
+    REQUIRE(list.removeIndices(indices) == 5);
+    REQUIRE(list.size() == 2995);
+    REQUIRE(list.shapeAt(0)->getX() == 2);
+    REQUIRE(list.shapeAt(497)->getX() == 499);
+    REQUIRE(list.shapeAt(498)->getX() == 501);
+    REQUIRE(list.back()->value->getX() == 2998);
+    REQUIRE(list.find(501, 1) == 498);
+
+    REQUIRE(list.removeIndices(vector<int>()) == 0);
+    REQUIRE(list.size() == 2995);
+  }
+
+  SECTION("Matches Remove At") {
+    // makes sure one pass removes the same shapes as repeated removeAt calls
+    CanvasList slow(list);
+    vector<int> indices;
+    for (int i = 0; i < 3000; i += 7) {
+      indices.push_back(i);
+    }
+    list.removeIndices(indices);
+    for (int i = static_cast<int>(indices.size()) - 1; i >= 0; i--) {
+      slow.removeAt(indices[i]);
+    }
+    REQUIRE(list.size() == slow.size());
+    ostringstream fast;
+    ostringstream expected;
+    list.draw(fast);
+    slow.draw(expected);
+    REQUIRE(fast.str() == expected.str());
+  }
+
+  SECTION("Background Free") {
+    // makes sure a large batch frees off the caller's thread and the list
+    // stays usable while it does
+    REQUIRE(list.removeIf([](const Shape &shape) { return shape.getX() % 2 == 0; }, true) == 1500);
+    REQUIRE(list.size() == 1500);
+    REQUIRE(list.removeIndices({0, 1, 2}, true) == 3);
+    list.push_back(new Shape(-1, -1));
+    REQUIRE(list.find(-1, -1) == 1497);
+    REQUIRE(list.removeIf([](const Shape &shape) { return shape.getY() == 5; }, true) > 0);
+    list.waitForFrees();
+    list.waitForFrees();
+
+    CanvasList other;
+    other.waitForFrees();
+    other.push_back(new Shape(1, 1));
+    REQUIRE(other.removeIf([](const Shape &) { return true; }, true) == 1);
+  }
+}
@@ -0,0 +1,124 @@
+// This file contains all the implementation functions used in threadpool.h
+// It spreads numbered tasks over per-worker queues and lets workers steal
+
+#include "threadpool.h"
+using namespace std;
+
+// Parameter constructor : starts the given number of workers
+// 0 or less starts one worker per hardware thread
+ThreadPool::ThreadPool(int threads) : job(nullptr), batch(0), stopping(false), remaining(0), steals(0) {
+    if (threads <= 0) {
+        threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    }
+    for (int i = 0; i < threads; i++) {
+        queues.push_back(make_unique<WorkQueue>());
+    }
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+// Destructor that stops and joins every worker
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> guard(stateLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (thread &worker : workers) {
+        worker.join();
+    }
+}
+
+// takes the next task for worker self
+// pops from the back of its own queue, else steals from the front of another
+// returns false once every queue is empty
+bool ThreadPool::take(int self, int &task) {
+    {
+        WorkQueue &own = *queues[self];
+        lock_guard<mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    int count = static_cast<int>(queues.size());
+    for (int i = 1; i < count; i++) {
+        WorkQueue &victim = *queues[(self + i) % count];
+        lock_guard<mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            steals++;
+            return true;
+        }
+    }
+    return false;
+}
+
+// body of each worker thread
+// sleeps until a new batch arrives, then runs tasks until none are left
+void ThreadPool::work(int self) {
+    long seen = 0;
+    while (true) {
+        {
+            unique_lock<mutex> guard(stateLock);
+            wake.wait(guard, [&] { return stopping || batch != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = batch;
+        }
+
+        // the job is read per task since a worker still draining one batch
+        // may already pick up tasks of the next
+        int task;
+        while (take(self, task)) {
+            (*job.load())(task);
+            if (remaining.fetch_sub(1) == 1) {
+                lock_guard<mutex> guard(stateLock);
+                finished.notify_all();
+            }
+        }
+    }
+}
+
+// runs task(0) through task(count - 1) on the workers and waits for all of them
+// each worker starts with one contiguous block of task numbers
+void ThreadPool::run(int count, const function<void(int)> &task) {
+    if (count <= 0) {
+        return;
+    }
+    lock_guard<mutex> runGuard(runLock);
+
+    // the job and count are published before any task can be taken
+    remaining = count;
+    job = &task;
+
+    int threads = static_cast<int>(queues.size());
+    for (int i = 0; i < threads; i++) {
+        lock_guard<mutex> guard(queues[i]->lock);
+        long first = static_cast<long>(count) * i / threads;
+        long last = static_cast<long>(count) * (i + 1) / threads;
+        for (long t = first; t < last; t++) {
+            queues[i]->tasks.push_back(static_cast<int>(t));
+        }
+    }
+
+    unique_lock<mutex> guard(stateLock);
+    batch++;
+    wake.notify_all();
+    finished.wait(guard, [&] { return remaining.load() == 0; });
+}
+
+// returns the number of workers
+int ThreadPool::size() const {
+    return static_cast<int>(workers.size());
+}
+
+// returns how many tasks were stolen from another worker's queue so far
+long ThreadPool::stealCount() const {
+    return steals.load();
+}
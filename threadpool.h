@@ -0,0 +1,59 @@
+/// @file threadpool.h
+/// @date October 2, 2023
+/// @brief The threadpool file contains declarations for the ThreadPool
+///     class, a fixed set of worker threads that run numbered tasks.
+///     Each worker owns a queue of task numbers and idle workers steal
+///     from the others, so uneven tasks still keep every core busy.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// The ThreadPool class runs batches of tasks numbered 0 to count - 1.
+// run() hands a batch to the workers and returns once all of it is done.
+// Only one batch runs at a time.
+class ThreadPool
+{
+    private:
+        struct WorkQueue
+        {
+            mutex lock;
+            deque<int> tasks;
+        };
+
+        vector<unique_ptr<WorkQueue>> queues;
+        vector<thread> workers;
+
+        mutex runLock;
+        mutex stateLock;
+        condition_variable wake;
+        condition_variable finished;
+        atomic<const function<void(int)> *> job;
+        long batch;
+        bool stopping;
+        atomic<int> remaining;
+        atomic<long> steals;
+
+        bool take(int self, int &task);
+        void work(int self);
+
+    public:
+        explicit ThreadPool(int threads = 0);
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool& operator=(const ThreadPool &) = delete;
+        ~ThreadPool();
+
+        void run(int count, const function<void(int)> &task);
+
+        int size() const;
+        long stealCount() const;
+};
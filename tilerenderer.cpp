@@ -0,0 +1,73 @@
+// This file contains all the implementation functions used in tilerenderer.h
+// It bins shapes into screen tiles and fills the tiles on the thread pool
+
+#include "tilerenderer.h"
+#include "rasterizer.h"
+#include <algorithm>
+using namespace std;
+
+// Parameter constructor : renders on pool using square tiles
+// tiles smaller than 1 pixel are widened to 1
+TileRenderer::TileRenderer(ThreadPool &pool, int tileSize) : pool(pool), tileSize(max(1, tileSize)) {}
+
+// draws every shape in canvas over the framebuffer
+// returns the number of pixels written
+long TileRenderer::render(const CanvasList &canvas, Framebuffer &target) {
+    int width = target.getWidth();
+    int height = target.getHeight();
+    if (width == 0 || height == 0) {
+        return 0;
+    }
+    int tilesX = (width + tileSize - 1) / tileSize;
+    int tilesY = (height + tileSize - 1) / tileSize;
+
+    // bins are kept between frames so their storage is reused
+    bins.resize(static_cast<size_t>(tilesX) * tilesY);
+    for (vector<Binned> &bin : bins) {
+        bin.clear();
+    }
+
+    // walks the canvas once in order so every bin ends up in list order
+    for (ShapeNode *curr = canvas.front(); curr != nullptr; curr = curr->next) {
+        Bounds b = curr->value->getBounds();
+        if (b.maxX < 0 || b.maxY < 0 || b.minX >= width || b.minY >= height) {
+            continue;
+        }
+        int firstX = max(b.minX, 0) / tileSize;
+        int lastX = min(b.maxX, width - 1) / tileSize;
+        int firstY = max(b.minY, 0) / tileSize;
+        int lastY = min(b.maxY, height - 1) / tileSize;
+
+        Binned binned{curr->value, Rasterizer::colorOf(*curr->value)};
+        for (int ty = firstY; ty <= lastY; ty++) {
+            for (int tx = firstX; tx <= lastX; tx++) {
+                bins[static_cast<size_t>(ty) * tilesX + tx].push_back(binned);
+            }
+        }
+    }
+
+    // fills each tile on its own, clipped to the tile
+    vector<long> written(bins.size(), 0);
+    pool.run(static_cast<int>(bins.size()), [&](int tile) {
+        int tx = tile % tilesX;
+        int ty = tile / tilesX;
+        Bounds clip{tx * tileSize, ty * tileSize, min(width, (tx + 1) * tileSize) - 1, min(height, (ty + 1) * tileSize) - 1};
+
+        long count = 0;
+        for (const Binned &binned : bins[tile]) {
+            count += Rasterizer::drawShape(*binned.shape, binned.color, target, clip);
+        }
+        written[tile] = count;
+    });
+
+    long total = 0;
+    for (long count : written) {
+        total += count;
+    }
+    return total;
+}
+
+// returns the side length of a tile in pixels
+int TileRenderer::getTileSize() const {
+    return tileSize;
+}
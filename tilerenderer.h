@@ -0,0 +1,41 @@
+/// @file tilerenderer.h
+/// @date October 2, 2023
+/// @brief The tilerenderer file contains declarations for the TileRenderer
+///     class that rasterizes a CanvasList on several threads. The screen
+///     is cut into square tiles, each shape is binned into the tiles its
+///     bounds touch, and tiles are filled in parallel on a ThreadPool.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "canvaslist.h"
+#include "framebuffer.h"
+#include "threadpool.h"
+
+using namespace std;
+
+// The TileRenderer class produces the same pixels as Rasterizer::render.
+// Every tile draws its shapes in CanvasList order, so later shapes still
+// paint over earlier ones, and no two threads ever write the same pixel.
+class TileRenderer
+{
+    private:
+        struct Binned
+        {
+            const Shape *shape;
+            uint32_t color;
+        };
+
+        ThreadPool &pool;
+        int tileSize;
+        vector<vector<Binned>> bins;
+
+    public:
+        static constexpr int DEFAULT_TILE_SIZE = 64;
+
+        explicit TileRenderer(ThreadPool &pool, int tileSize = DEFAULT_TILE_SIZE);
+
+        long render(const CanvasList &, Framebuffer &);
+        int getTileSize() const;
+};
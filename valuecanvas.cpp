@@ -0,0 +1,208 @@
+// This file contains all the implementation functions used in valuecanvas.h
+// Visitors name the member they call with the alternative's own class,
+// which turns each virtual call into a direct one
+
+#include "valuecanvas.h"
+#include <iostream>
+#include <type_traits>
+#include "blockwriter.h"
+using namespace std;
+
+// returns a ShapeValue holding a copy of shape
+ShapeValue toValue(const Shape &shape) {
+    switch (shape.getType()) {
+        case SHAPE_CIRCLE: return ShapeValue(in_place_type<Circle>, static_cast<const Circle &>(shape));
+        case SHAPE_RECT: return ShapeValue(in_place_type<Rect>, static_cast<const Rect &>(shape));
+        case SHAPE_RIGHT_TRIANGLE:
+            return ShapeValue(in_place_type<RightTriangle>, static_cast<const RightTriangle &>(shape));
+        default: return ShapeValue(in_place_type<Shape>, shape);
+    }
+}
+
+// returns a new heap shape holding a copy of value, owned by the caller
+Shape* toShape(const ShapeValue &value) {
+    return visit([](const auto &shape) -> Shape* {
+        return new decay_t<decltype(shape)>(shape);
+    }, value);
+}
+
+// returns the alternative in value as its Shape base
+const Shape& asShape(const ShapeValue &value) {
+    return visit([](const Shape &shape) -> const Shape& { return shape; }, value);
+}
+
+// returns the alternative in value as its Shape base
+Shape& asShape(ShapeValue &value) {
+    return visit([](Shape &shape) -> Shape& { return shape; }, value);
+}
+
+// appends the printShape text of value to out
+// returns the number of characters appended
+size_t printValue(const ShapeValue &value, string &out) {
+    size_t start = out.size();
+    out.resize(start + Shape::MAX_TEXT_LENGTH);
+    size_t length = visit([&](const auto &shape) {
+        using Type = decay_t<decltype(shape)>;
+        return shape.Type::printShape(&out[start], Shape::MAX_TEXT_LENGTH);
+    }, value);
+    out.resize(start + length);
+    return length;
+}
+
+// Default constructor : initializes empty valueCanvas
+ValueCanvas::ValueCanvas() {}
+
+// Conversion Constructor : creates new valueCanvas holding copies of a canvasList's shapes
+ValueCanvas::ValueCanvas(const CanvasList &list) {
+    shapes.reserve(list.size());
+    for (ShapeNode *curr = list.front(); curr != nullptr; curr = curr->next) {
+        shapes.push_back(toValue(*curr->value));
+    }
+}
+
+// clears the array
+void ValueCanvas::clear() {
+    shapes.clear();
+}
+
+// reserves room for the given number of shapes so pushes do not reallocate
+void ValueCanvas::reserve(int capacity) {
+    if (capacity > 0) {
+        shapes.reserve(capacity);
+    }
+}
+
+// inserts a copy of shape after given index
+// does nothing if index is out of range
+void ValueCanvas::insertAfter(int idx, const ShapeValue &shape) {
+    if (idx < 0 || idx >= size()) {
+        return;
+    }
+    shapes.insert(shapes.begin() + idx + 1, shape);
+}
+
+// pushes a copy of shape to front of array
+void ValueCanvas::push_front(const ShapeValue &shape) {
+    shapes.insert(shapes.begin(), shape);
+}
+
+// pushes a copy of shape to back of array
+void ValueCanvas::push_back(const ShapeValue &shape) {
+    shapes.push_back(shape);
+}
+
+// removes shape at given index
+// does nothing if index is out of range
+void ValueCanvas::removeAt(int idx) {
+    if (idx < 0 || idx >= size()) {
+        return;
+    }
+    shapes.erase(shapes.begin() + idx);
+}
+
+// removes every other shape starting with index 1
+void ValueCanvas::removeEveryOther() {
+    int kept = 0;
+    for (int idx = 0; idx < size(); idx += 2) {
+        if (kept != idx) {
+            shapes[kept] = move(shapes[idx]);
+        }
+        kept++;
+    }
+    shapes.resize(kept);
+}
+
+// moves front of array shape into shape and removes it
+// returns false if array is empty
+bool ValueCanvas::pop_front(ShapeValue &shape) {
+    if (isempty()) {
+        return false;
+    }
+    shape = move(shapes.front());
+    shapes.erase(shapes.begin());
+    return true;
+}
+
+// moves back of array shape into shape and removes it
+// returns false if array is empty
+bool ValueCanvas::pop_back(ShapeValue &shape) {
+    if (isempty()) {
+        return false;
+    }
+    shape = move(shapes.back());
+    shapes.pop_back();
+    return true;
+}
+
+// returns true if array is empty and false if it is not
+bool ValueCanvas::isempty() const {
+    return shapes.empty();
+}
+
+// returns size of array
+int ValueCanvas::size() const {
+    return static_cast<int>(shapes.size());
+}
+
+// finds index of shape with given points
+// returns -1 if shape not found
+// return index if shape is found
+int ValueCanvas::find(int x, int y) const {
+    for (int idx = 0; idx < size(); idx++) {
+        const Shape &shape = asShape(shapes[idx]);
+        if (shape.getX() == x && shape.getY() == y) {
+            return idx;
+        }
+    }
+    return -1;
+}
+
+// returns pointer to shape at given index
+// returns nullpointer if index is out of range
+// the pointer is invalidated by any insertion or removal
+const ShapeValue* ValueCanvas::shapeAt(int idx) const {
+    if (idx < 0 || idx >= size()) {
+        return nullptr;
+    }
+    return &shapes[idx];
+}
+
+// returns pointer to shape at given index
+// returns nullpointer if index is out of range
+ShapeValue* ValueCanvas::shapeAt(int idx) {
+    if (idx < 0 || idx >= size()) {
+        return nullptr;
+    }
+    return &shapes[idx];
+}
+
+// pushes heap copies of every shape onto the back of list, in order
+void ValueCanvas::appendTo(CanvasList &list) const {
+    for (const ShapeValue &shape : shapes) {
+        list.push_back(toShape(shape));
+    }
+}
+
+// draws all shapes in array to standard output
+void ValueCanvas::draw() const {
+    draw(cout);
+    cout.flush();
+}
+
+// draws all shapes in array to out, one printShape line per shape
+void ValueCanvas::draw(ostream &out) const {
+    BlockWriter writer(out);
+    for (const ShapeValue &shape : shapes) {
+        printValue(shape, writer.text());
+        writer.endLine();
+    }
+}
+
+// draws all shapes in array to an open file descriptor
+void ValueCanvas::draw(int fd) const {
+    BlockWriter writer(fd);
+    for (const ShapeValue &shape : shapes) {
+        printValue(shape, writer.text());
+        writer.endLine();
+    }
+}
@@ -0,0 +1,72 @@
+/// @file valuecanvas.h
+/// @date October 2, 2023
+/// @brief The valuecanvas file contains declarations for ShapeValue, a
+///     closed variant over the four shape classes, and the ValueCanvas
+///     class that keeps those values inline in one array. Shapes are
+///     copied and stored by value, and draw, copy and find dispatch
+///     through std::visit rather than through the vtable.
+
+#pragma once
+
+#include <ostream>
+#include <variant>
+#include <vector>
+#include "shape.h"
+#include "canvaslist.h"
+
+using namespace std;
+
+// ShapeValue holds any one shape by value
+// the alternatives are listed in ShapeType order
+using ShapeValue = variant<Shape, Circle, Rect, RightTriangle>;
+
+// returns a ShapeValue holding a copy of shape
+ShapeValue toValue(const Shape &shape);
+
+// returns a new heap shape holding a copy of value, owned by the caller
+Shape* toShape(const ShapeValue &value);
+
+// returns the alternative in value as its Shape base
+const Shape& asShape(const ShapeValue &value);
+Shape& asShape(ShapeValue &value);
+
+// writes the printShape text of value without a virtual call
+size_t printValue(const ShapeValue &value, string &out);
+
+// The ValueCanvas class stores shapes in the same order a CanvasList does
+// but inline, so there is no allocation per shape and no ownership to
+// hand over. Copying a ValueCanvas copies the array.
+class ValueCanvas
+{
+    private:
+        vector<ShapeValue> shapes;
+
+    public:
+        ValueCanvas();
+        explicit ValueCanvas(const CanvasList &);
+
+        void clear();
+        void reserve(int);
+
+        void insertAfter(int, const ShapeValue &);
+        void push_front(const ShapeValue &);
+        void push_back(const ShapeValue &);
+
+        void removeAt(int);
+        void removeEveryOther();
+        bool pop_front(ShapeValue &);
+        bool pop_back(ShapeValue &);
+
+        bool isempty() const;
+        int size() const;
+
+        int find(int x, int y) const;
+        const ShapeValue* shapeAt(int) const;
+        ShapeValue* shapeAt(int);
+
+        void appendTo(CanvasList &) const;
+
+        void draw() const;
+        void draw(ostream &) const;
+        void draw(int fd) const;
+};